@@ -0,0 +1,160 @@
+#include "GestureClassifier.h"
+
+#include <stdlib.h>
+
+//A flick rolls the wrist around the forearm, which swings gravity across the
+//watch X axis and back. Samples are high-passed against a slow running
+//baseline (all in mG, integer only) and a flick is a strong lobe on X followed
+//by a lobe of the opposite sign within a short window. The sign of the first
+//lobe gives the direction. Anything that does not complete the pair is noise.
+
+#define BASELINE_SHIFT 3
+#define LOBE_THRESHOLD 550
+#define RETURN_THRESHOLD (LOBE_THRESHOLD / 2)
+#define CROSS_AXIS_SHIFT 1
+#define RETURN_WINDOW 6
+#define REFRACTORY_SAMPLES 10
+#define MOTION_THRESHOLD 150
+
+typedef enum
+{
+	STATE_IDLE,
+	STATE_LOBE,
+	STATE_REFRACTORY
+} ClassifierState;
+
+typedef struct
+{
+	int32_t baseline_x;
+	int32_t baseline_y;
+	int32_t baseline_z;
+	ClassifierState state;
+	int sign;
+	int countdown;
+	int primed;
+	int motion;
+} GestureClassifier;
+
+static int32_t abs32(int32_t value)
+{
+	return value < 0 ? -value : value;
+}
+
+void* init_gesture_classifier()
+{
+	GestureClassifier* gc = malloc(sizeof(GestureClassifier));
+	
+	if (NULL == gc)
+	{
+		return NULL;
+	}
+	
+	reset_gesture_classifier(gc);
+	return (void*)gc;
+}
+
+void destroy_gesture_classifier(void* classifier)
+{
+	free(classifier);
+}
+
+void reset_gesture_classifier(void* classifier)
+{
+	GestureClassifier* gc = (GestureClassifier*)classifier;
+	
+	gc->baseline_x = 0;
+	gc->baseline_y = 0;
+	gc->baseline_z = 0;
+	gc->state = STATE_IDLE;
+	gc->sign = 0;
+	gc->countdown = 0;
+	gc->primed = 0;
+	gc->motion = 0;
+}
+
+Gesture classify_gesture_batch(void* classifier, AccelData* samples, uint32_t num_samples)
+{
+	GestureClassifier* gc = (GestureClassifier*)classifier;
+	Gesture result = GESTURE_NONE;
+	uint32_t i = 0;
+	
+	gc->motion = 0;
+	
+	for (; i < num_samples; ++i)
+	{
+		AccelData* sample = &samples[i];
+		int32_t dx;
+		int32_t cross;
+		
+		//the motor can fake a lobe, so drop one in progress, but keep the
+		//lockout after a detection running
+		if (sample->did_vibrate)
+		{
+			if (gc->state == STATE_LOBE)
+			{
+				gc->state = STATE_IDLE;
+			}
+			continue;
+		}
+		
+		if (!gc->primed)
+		{
+			gc->baseline_x = sample->x;
+			gc->baseline_y = sample->y;
+			gc->baseline_z = sample->z;
+			gc->primed = 1;
+			continue;
+		}
+		
+		dx = sample->x - gc->baseline_x;
+		cross = abs32(sample->y - gc->baseline_y) + abs32(sample->z - gc->baseline_z);
+		
+		gc->baseline_x += dx >> BASELINE_SHIFT;
+		gc->baseline_y += (sample->y - gc->baseline_y) >> BASELINE_SHIFT;
+		gc->baseline_z += (sample->z - gc->baseline_z) >> BASELINE_SHIFT;
+		
+		if ((abs32(dx) + cross) >= MOTION_THRESHOLD)
+		{
+			gc->motion = 1;
+		}
+		
+		switch (gc->state)
+		{
+		case STATE_IDLE:
+			//the X swing has to dominate, otherwise it is an arm movement
+			if ((abs32(dx) >= LOBE_THRESHOLD) && (abs32(dx) > (cross >> CROSS_AXIS_SHIFT)))
+			{
+				gc->sign = dx > 0 ? 1 : -1;
+				gc->countdown = RETURN_WINDOW;
+				gc->state = STATE_LOBE;
+			}
+			break;
+		case STATE_LOBE:
+			if ((dx * gc->sign) <= -RETURN_THRESHOLD)
+			{
+				result = gc->sign > 0 ? GESTURE_FORWARD : GESTURE_BACKWARD;
+				gc->countdown = REFRACTORY_SAMPLES;
+				gc->state = STATE_REFRACTORY;
+			}
+			else if (--gc->countdown == 0)
+			{
+				gc->state = STATE_IDLE;
+			}
+			break;
+		case STATE_REFRACTORY:
+			if (--gc->countdown == 0)
+			{
+				gc->state = STATE_IDLE;
+			}
+			break;
+		}
+	}
+	
+	return result;
+}
+
+int gesture_batch_had_motion(void* classifier)
+{
+	GestureClassifier* gc = (GestureClassifier*)classifier;
+	return gc->motion;
+}
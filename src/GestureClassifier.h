@@ -0,0 +1,20 @@
+#ifndef __GESTURE_CLASSIFIER_H__
+#define __GESTURE_CLASSIFIER_H__
+
+#include <pebble.h>
+
+typedef enum
+{
+	GESTURE_NONE = 0,
+	GESTURE_FORWARD = 1,
+	GESTURE_BACKWARD = -1
+} Gesture;
+
+void* init_gesture_classifier();
+void destroy_gesture_classifier(void* classifier);
+
+void reset_gesture_classifier(void* classifier);
+Gesture classify_gesture_batch(void* classifier, AccelData* samples, uint32_t num_samples);
+int gesture_batch_had_motion(void* classifier);
+
+#endif
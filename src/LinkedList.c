@@ -20,7 +20,7 @@ int ll_is_index_in_range(void* linked_list, int index)
 	LinkedList* lc = (LinkedList*)linked_list;
 	int count = lc->count;
 	
-	if (index + 1 >= count)
+	if (index >= count)
 	{
 		return 0;
 	}
@@ -57,6 +57,7 @@ void ll_destroy_linked_list(void* linked_list)
 	}
 	
 	free(current);
+	free(lc);
 }
 
 int ll_add_item(void* linked_list, void* item)
@@ -96,83 +97,99 @@ int ll_add_item_at(void* linked_list, void* item, int index)
 	LinkedListNode* temp;
 	int current_index = 0;
 	
-	if (index > (lc->count - 1))
+	if (index == (lc->count - 1))
 	{
-		return 0;
+		return ll_add_item(linked_list, item);
 	}
 	
-	if (index == (lc->count - 1))
+	if (!ll_is_index_in_range(linked_list, index))
 	{
-		return ll_add_item(linked_list, item);
+		return 0;
 	}
 	
 	while (current_index != index)
 	{
 		current = current->next_node;
+		++current_index;
 	}
 	
 	temp = current->next_node;
 	current->next_node = malloc(sizeof(LinkedListNode));
 	if (NULL == current->next_node)
 	{
+		current->next_node = temp;
 		return 0;
 	}
 	
 	current->next_node->item = item;
 	current->next_node->next_node = temp;
+	++lc->count;
+	
+	if (lc->current_index > index)
+	{
+		++lc->current_index;
+	}
 	return 1;
 }
 
-int ll_remove_item(void* linked_list, void* item)
+static void ll_unlink_node(LinkedList* lc, LinkedListNode* previous, int index)
 {
-	LinkedList* lc = (LinkedList*)linked_list;
-	LinkedListNode* current = lc->head;
-	LinkedListNode* temp;
-	int index = 0;
+	LinkedListNode* node;
+	
+	if (NULL == previous)
+	{
+		node = lc->head;
+		
+		//the head node is always allocated, an emptied list just clears it
+		if (NULL == node->next_node)
+		{
+			node->item = NULL;
+		}
+		else
+		{
+			lc->head = node->next_node;
+			free(node);
+		}
+	}
+	else
+	{
+		node = previous->next_node;
+		previous->next_node = node->next_node;
+		free(node);
+	}
+	
+	--lc->count;
 	
 	if (lc->count == 0)
 	{
-		return 0;
+		lc->current_index = -1;
+	}
+	else if (index < lc->current_index)
+	{
+		--lc->current_index;
+	}
+	else if (index == lc->current_index)
+	{
+		lc->current_index = (index == 0) ? (lc->count - 1) : (index - 1);
 	}
+}
+
+int ll_remove_item(void* linked_list, void* item)
+{
+	LinkedList* lc = (LinkedList*)linked_list;
+	LinkedListNode* current = lc->head;
+	LinkedListNode* previous = NULL;
+	int index = 0;
 	
-	while (current->next_node != NULL)
+	for (; index < lc->count; ++index)
 	{
-		if (current->next_node->item == item)
+		if (current->item == item)
 		{
-			if (!current->next_node->next_node)
-			{
-				free(current->next_node);
-				current->next_node = NULL;
-				--lc->count;
-				
-				if (lc->count == 0)
-				{
-					lc->current_index = -1;
-				}
-				
-				else if (lc->current_index == index)
-				{
-					lc->current_index = ll_get_previous_index(linked_list);
-				}
-				
-				return 1;
-			}
-			else
-			{
-				temp = current->next_node;
-				current->next_node = temp->next_node;
-				
-				free(temp);
-				
-				if (lc->current_index == index)
-				{
-					lc->current_index = ll_get_previous_index(linked_list);
-				}
-				
-				return 1;
-			}
-		}	
-		++index;
+			ll_unlink_node(lc, previous, index);
+			return 1;
+		}
+		previous = current;
+		current = current->next_node;
 	}
 	
 	return 0;
@@ -180,7 +197,8 @@ int ll_remove_item(void* linked_list, void* item)
 
 int ll_remove_item_at(void* linked_list, int index)
 {
-	void* item = NULL;
+	LinkedList* lc = (LinkedList*)linked_list;
+	LinkedListNode* previous = NULL;
 	int i = 0;
 	
 	if (!ll_is_index_in_range(linked_list, index))
@@ -188,12 +206,13 @@ int ll_remove_item_at(void* linked_list, int index)
 		return 0;
 	}
 	
-	for(;i < index; ++i)
+	for (; i < index; ++i)
 	{
-		item = ll_get_next_item(linked_list);
+		previous = (NULL == previous) ? lc->head : previous->next_node;
 	}
 	
-	return ll_remove_item(linked_list, item);
+	ll_unlink_node(lc, previous, index);
+	return 1;
 }
 
 int ll_get_next_index(void* linked_list)
@@ -209,7 +228,7 @@ int ll_get_next_index(void* linked_list)
 int ll_get_previous_index(void* linked_list)
 {
 	LinkedList* lc = (LinkedList*)linked_list;
-	if ((lc->current_index - 1) == 0)
+	if (lc->current_index <= 0)
 	{
 		return lc->count - 1;
 	}
@@ -241,6 +260,11 @@ void* ll_get_current_item(void* linked_list)
 	LinkedListNode* current = lc->head;
 	int i = 0;
 	
+	if ((lc->count) == 0)
+	{
+		return NULL;
+	}
+	
 	if ((lc->current_index) == -1)
 	{
 		lc->current_index = 0;
@@ -292,9 +316,14 @@ void* ll_get_previous_item(void* linked_list)
 {
 	LinkedList* lc = (LinkedList*)linked_list;
 	LinkedListNode* current = lc->head;
-	int i = lc->count - 1;
+	int i = 0;
 	
-	if (lc->current_index == 0)
+	if ((lc->count) == 0)
+	{
+		return NULL;
+	}
+	
+	if (lc->current_index <= 0)
 	{
 		lc->current_index = lc->count - 1;
 		while (NULL != current->next_node)
@@ -306,7 +335,7 @@ void* ll_get_previous_item(void* linked_list)
 	
 	--lc->current_index;
 	
-	for(;i > lc->current_index; --i)
+	for(;i < lc->current_index; ++i)
 	{
 		current = current->next_node;
 	}
@@ -332,6 +361,11 @@ int ll_find_item(void* linked_list, void* item)
 	LinkedListNode* current = lc->head;
 	int index = 0;
 	
+	if ((lc->count) == 0)
+	{
+		return -1;
+	}
+	
 	while (current->next_node != NULL)
 	{
 		if (current->item == item)
@@ -0,0 +1,272 @@
+#include "LogStore.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+//Records are appended into a RAM chunk and only hit flash when the chunk fills
+//up (or on flush/close). Chunks live under keys base_key + 1 .. base_key + chunk_count
+//and are reused as a ring, the header under base_key says where the ring starts.
+//A partially filled chunk is loaded back on open and topped up under the same
+//key, so rotation only ever retires whole, densely packed chunks.
+
+#define LOG_STORE_MAGIC 0x4C4F4753
+
+typedef struct
+{
+	uint32_t magic;
+	uint16_t record_size;
+	uint8_t chunk_count;
+	uint8_t head;
+	uint8_t full_chunks;
+	uint16_t tail_records;
+} __attribute__((__packed__)) LogStoreHeader;
+
+typedef struct
+{
+	uint32_t base_key;
+	uint16_t records_per_chunk;
+	int dirty;
+	LogStoreHeader header;
+	uint8_t chunk[PERSIST_DATA_MAX_LENGTH];
+} LogStore;
+
+typedef struct
+{
+	LogStore* store;
+	int chunk_offset;
+	uint16_t records;
+	uint16_t position;
+	const uint8_t* data;
+	uint8_t chunk[PERSIST_DATA_MAX_LENGTH];
+} LogStoreIterator;
+
+static uint32_t chunk_key(LogStore* ls, int chunk)
+{
+	return ls->base_key + 1 + chunk;
+}
+
+static void write_header(LogStore* ls)
+{
+	persist_write_data(ls->base_key, &ls->header, sizeof(ls->header));
+}
+
+void* ls_open(uint32_t base_key, uint16_t record_size, uint8_t chunk_count)
+{
+	LogStore* ls;
+	LogStoreHeader stored;
+	
+	if ((record_size == 0) || (record_size > PERSIST_DATA_MAX_LENGTH) || (chunk_count < 2))
+	{
+		return NULL;
+	}
+	
+	ls = malloc(sizeof(LogStore));
+	if (NULL == ls)
+	{
+		return NULL;
+	}
+	
+	ls->base_key = base_key;
+	ls->records_per_chunk = PERSIST_DATA_MAX_LENGTH / record_size;
+	ls->dirty = 0;
+	ls->header.magic = LOG_STORE_MAGIC;
+	ls->header.record_size = record_size;
+	ls->header.chunk_count = chunk_count;
+	ls->header.head = 0;
+	ls->header.full_chunks = 0;
+	ls->header.tail_records = 0;
+	
+	if ((persist_read_data(base_key, &stored, sizeof(stored)) == (int)sizeof(stored)) &&
+		(stored.magic == LOG_STORE_MAGIC) &&
+		(stored.record_size == record_size) &&
+		(stored.chunk_count == chunk_count) &&
+		(stored.tail_records < ls->records_per_chunk))
+	{
+		ls->header = stored;
+		
+		if (ls->header.tail_records > 0)
+		{
+			persist_read_data(chunk_key(ls, ls->header.head), ls->chunk, ls->header.tail_records * record_size);
+		}
+	}
+	
+	return (void*)ls;
+}
+
+void ls_close(void* log_store)
+{
+	ls_flush(log_store);
+	free(log_store);
+}
+
+int ls_append(void* log_store, const void* record)
+{
+	LogStore* ls = (LogStore*)log_store;
+	uint16_t size = ls->header.record_size;
+	
+	memcpy(&ls->chunk[ls->header.tail_records * size], record, size);
+	++ls->header.tail_records;
+	ls->dirty = 1;
+	
+	if (ls->header.tail_records < ls->records_per_chunk)
+	{
+		return 1;
+	}
+	
+	//chunk is full, persist it and retire the oldest one to make room
+	persist_write_data(chunk_key(ls, ls->header.head), ls->chunk, ls->records_per_chunk * size);
+	
+	ls->header.head = (ls->header.head + 1) % ls->header.chunk_count;
+	if (ls->header.full_chunks < (ls->header.chunk_count - 1))
+	{
+		++ls->header.full_chunks;
+	}
+	ls->header.tail_records = 0;
+	
+	write_header(ls);
+	ls->dirty = 0;
+	return 1;
+}
+
+int ls_replace_last(void* log_store, const void* record)
+{
+	LogStore* ls = (LogStore*)log_store;
+	uint16_t size = ls->header.record_size;
+	uint32_t key;
+	
+	if (ls->header.tail_records > 0)
+	{
+		memcpy(&ls->chunk[(ls->header.tail_records - 1) * size], record, size);
+		ls->dirty = 1;
+		return 1;
+	}
+	
+	if (ls->header.full_chunks == 0)
+	{
+		return 0;
+	}
+	
+	//the last record closed the previous chunk, rewrite that chunk in place
+	//using the RAM chunk, which is empty right after a rotation
+	key = chunk_key(ls, (ls->header.head + ls->header.chunk_count - 1) % ls->header.chunk_count);
+	if (persist_read_data(key, ls->chunk, ls->records_per_chunk * size) != (int)(ls->records_per_chunk * size))
+	{
+		return 0;
+	}
+	
+	memcpy(&ls->chunk[(ls->records_per_chunk - 1) * size], record, size);
+	persist_write_data(key, ls->chunk, ls->records_per_chunk * size);
+	return 1;
+}
+
+int ls_flush(void* log_store)
+{
+	LogStore* ls = (LogStore*)log_store;
+	
+	if (!ls->dirty)
+	{
+		return 0;
+	}
+	
+	if (ls->header.tail_records > 0)
+	{
+		persist_write_data(chunk_key(ls, ls->header.head), ls->chunk, ls->header.tail_records * ls->header.record_size);
+	}
+	
+	write_header(ls);
+	ls->dirty = 0;
+	return 1;
+}
+
+void ls_clear(void* log_store)
+{
+	LogStore* ls = (LogStore*)log_store;
+	int i = 0;
+	
+	for (; i < ls->header.chunk_count; ++i)
+	{
+		persist_delete(chunk_key(ls, i));
+	}
+	
+	ls->header.head = 0;
+	ls->header.full_chunks = 0;
+	ls->header.tail_records = 0;
+	write_header(ls);
+	ls->dirty = 0;
+}
+
+int ls_record_count(void* log_store)
+{
+	LogStore* ls = (LogStore*)log_store;
+	return (ls->header.full_chunks * ls->records_per_chunk) + ls->header.tail_records;
+}
+
+static int load_chunk(LogStoreIterator* it)
+{
+	LogStore* ls = it->store;
+	int chunk;
+	
+	while (it->chunk_offset < ls->header.full_chunks)
+	{
+		chunk = (ls->header.head - ls->header.full_chunks + it->chunk_offset + ls->header.chunk_count) % ls->header.chunk_count;
+		++it->chunk_offset;
+		
+		if (persist_read_data(chunk_key(ls, chunk), it->chunk, ls->records_per_chunk * ls->header.record_size) > 0)
+		{
+			it->data = it->chunk;
+			it->records = ls->records_per_chunk;
+			it->position = 0;
+			return 1;
+		}
+	}
+	
+	//the newest records are still in RAM, read them in place
+	if (it->chunk_offset == ls->header.full_chunks)
+	{
+		++it->chunk_offset;
+		it->data = ls->chunk;
+		it->records = ls->header.tail_records;
+		it->position = 0;
+		return it->records > 0;
+	}
+	
+	return 0;
+}
+
+void* ls_iterator_create(void* log_store)
+{
+	LogStoreIterator* it = malloc(sizeof(LogStoreIterator));
+	
+	if (NULL == it)
+	{
+		return NULL;
+	}
+	
+	it->store = (LogStore*)log_store;
+	it->chunk_offset = 0;
+	it->records = 0;
+	it->position = 0;
+	it->data = NULL;
+	
+	return (void*)it;
+}
+
+const void* ls_iterator_next(void* iterator)
+{
+	LogStoreIterator* it = (LogStoreIterator*)iterator;
+	const void* record;
+	
+	if ((it->position == it->records) && !load_chunk(it))
+	{
+		return NULL;
+	}
+	
+	record = &it->data[it->position * it->store->header.record_size];
+	++it->position;
+	return record;
+}
+
+void ls_iterator_destroy(void* iterator)
+{
+	free(iterator);
+}
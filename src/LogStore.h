@@ -0,0 +1,20 @@
+#ifndef __LOG_STORE_H__
+#define __LOG_STORE_H__
+
+#include <pebble.h>
+
+void* ls_open(uint32_t base_key, uint16_t record_size, uint8_t chunk_count);
+void ls_close(void* log_store);
+
+int ls_append(void* log_store, const void* record);
+int ls_replace_last(void* log_store, const void* record);
+int ls_flush(void* log_store);
+void ls_clear(void* log_store);
+
+int ls_record_count(void* log_store);
+
+void* ls_iterator_create(void* log_store);
+const void* ls_iterator_next(void* iterator);
+void ls_iterator_destroy(void* iterator);
+
+#endif
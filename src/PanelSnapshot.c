@@ -0,0 +1,266 @@
+#include "PanelSnapshot.h"
+#include "LinkedList.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+//Panels are rendered once into a bitmap whenever their content changes, and
+//slide animations move a layer that only blits that bitmap. There is no
+//offscreen GContext, so the rasterizer is a layer stacked on top of the panel
+//region: when a snapshot is stale it saves the region, draws the panel there,
+//copies the pixels out of the frame buffer and puts the saved region back.
+//Captured regions must start on a byte boundary of the 1 bit frame buffer.
+
+typedef struct
+{
+	Layer* layer;
+	Layer* parent;
+	GRect region;
+	GBitmap* scratch;
+	void* snapshots;
+	int pending;
+} PanelRasterizer;
+
+typedef struct
+{
+	PanelRasterizer* rasterizer;
+	Layer* live_layer;
+	Layer* layer;
+	GBitmap* cache;
+	PanelRenderer render;
+	void* context;
+	int valid;
+	int active;
+} PanelSnapshot;
+
+//copies size pixels between byte aligned origins; the frame buffer side is at
+//the region's origin, the bitmap side at 0,0
+static void copy_rows(GBitmap* destination, GPoint to_origin, GBitmap* source, GPoint from_origin, GSize size)
+{
+	int row_bytes = (size.w + 7) / 8;
+	uint8_t* to = (uint8_t*)destination->addr + (to_origin.y * destination->row_size_bytes) + (to_origin.x / 8);
+	uint8_t* from = (uint8_t*)source->addr + (from_origin.y * source->row_size_bytes) + (from_origin.x / 8);
+	int i = 0;
+	
+	for (; i < size.h; ++i)
+	{
+		memcpy(to, from, row_bytes);
+		to += destination->row_size_bytes;
+		from += source->row_size_bytes;
+	}
+}
+
+int capture_screen_region(GContext* ctx, GRect region, GBitmap* destination)
+{
+	GBitmap* frame_buffer;
+	
+	if ((region.origin.x % 8) != 0)
+	{
+		return 0;
+	}
+	
+	frame_buffer = graphics_capture_frame_buffer(ctx);
+	if (NULL == frame_buffer)
+	{
+		return 0;
+	}
+	
+	copy_rows(destination, GPoint(0, 0), frame_buffer, region.origin, region.size);
+	graphics_release_frame_buffer(ctx, frame_buffer);
+	return 1;
+}
+
+static void rasterizer_update_proc(Layer* layer, GContext* ctx)
+{
+	PanelRasterizer* pr = *(PanelRasterizer**)layer_get_data(layer);
+	GRect local = GRect(0, 0, pr->region.size.w, pr->region.size.h);
+	PanelSnapshot* snapshot;
+	GBitmap* frame_buffer;
+	int count = ll_item_count(pr->snapshots);
+	int i = 0;
+	
+	if (!pr->pending)
+	{
+		return;
+	}
+	
+	if (!capture_screen_region(ctx, pr->region, pr->scratch))
+	{
+		return;
+	}
+	
+	for (; i < count; ++i)
+	{
+		snapshot = (PanelSnapshot*)ll_get_next_item(pr->snapshots);
+		if (snapshot->valid)
+		{
+			continue;
+		}
+		
+		snapshot->render(ctx, local, snapshot->context);
+		
+		snapshot->valid = capture_screen_region(ctx, pr->region, snapshot->cache);
+		if (snapshot->active)
+		{
+			layer_mark_dirty(snapshot->layer);
+		}
+	}
+	
+	frame_buffer = graphics_capture_frame_buffer(ctx);
+	copy_rows(frame_buffer, pr->region.origin, pr->scratch, GPoint(0, 0), pr->region.size);
+	graphics_release_frame_buffer(ctx, frame_buffer);
+	
+	pr->pending = 0;
+}
+
+static void snapshot_update_proc(Layer* layer, GContext* ctx)
+{
+	PanelSnapshot* snapshot = *(PanelSnapshot**)layer_get_data(layer);
+	GRect bounds = layer_get_bounds(layer);
+	
+	if (snapshot->valid)
+	{
+		graphics_draw_bitmap_in_rect(ctx, snapshot->cache, bounds);
+	}
+	else
+	{
+		//not rasterized yet, draw it the slow way for this frame
+		snapshot->render(ctx, bounds, snapshot->context);
+	}
+}
+
+void* init_panel_rasterizer(Layer* parent, GRect region)
+{
+	PanelRasterizer* pr = malloc(sizeof(PanelRasterizer));
+	
+	if (NULL == pr)
+	{
+		return NULL;
+	}
+	
+	pr->parent = parent;
+	pr->region = region;
+	pr->scratch = gbitmap_create_blank(region.size);
+	pr->snapshots = ll_init_linked_list();
+	pr->pending = 0;
+	
+	pr->layer = layer_create_with_data(region, sizeof(PanelRasterizer*));
+	*(PanelRasterizer**)layer_get_data(pr->layer) = pr;
+	layer_set_update_proc(pr->layer, rasterizer_update_proc);
+	layer_add_child(parent, pr->layer);
+	
+	return (void*)pr;
+}
+
+void destroy_panel_rasterizer(void* rasterizer)
+{
+	PanelRasterizer* pr = (PanelRasterizer*)rasterizer;
+	PanelSnapshot* snapshot;
+	int count = ll_item_count(pr->snapshots);
+	int i = 0;
+	
+	for (; i < count; ++i)
+	{
+		snapshot = (PanelSnapshot*)ll_get_next_item(pr->snapshots);
+		layer_destroy(snapshot->layer);
+		gbitmap_destroy(snapshot->cache);
+		free(snapshot);
+	}
+	
+	ll_destroy_linked_list(pr->snapshots);
+	layer_destroy(pr->layer);
+	gbitmap_destroy(pr->scratch);
+	free(pr);
+}
+
+void* add_panel_snapshot(void* rasterizer, Layer* live_layer, PanelRenderer render, void* context)
+{
+	PanelRasterizer* pr = (PanelRasterizer*)rasterizer;
+	PanelSnapshot* snapshot = malloc(sizeof(PanelSnapshot));
+	
+	if (NULL == snapshot)
+	{
+		return NULL;
+	}
+	
+	snapshot->rasterizer = pr;
+	snapshot->live_layer = live_layer;
+	snapshot->cache = gbitmap_create_blank(pr->region.size);
+	snapshot->render = render;
+	snapshot->context = context;
+	snapshot->valid = 0;
+	snapshot->active = 0;
+	
+	snapshot->layer = layer_create_with_data(layer_get_frame(live_layer), sizeof(PanelSnapshot*));
+	*(PanelSnapshot**)layer_get_data(snapshot->layer) = snapshot;
+	layer_set_update_proc(snapshot->layer, snapshot_update_proc);
+	layer_set_hidden(snapshot->layer, true);
+	layer_add_child(pr->parent, snapshot->layer);
+	
+	//the rasterizer has to stay above everything it captures
+	layer_remove_from_parent(pr->layer);
+	layer_add_child(pr->parent, pr->layer);
+	
+	ll_add_item(pr->snapshots, snapshot);
+	invalidate_panel_snapshot(snapshot);
+	
+	return (void*)snapshot;
+}
+
+void* find_panel_snapshot(void* rasterizer, Layer* live_layer)
+{
+	PanelRasterizer* pr = (PanelRasterizer*)rasterizer;
+	PanelSnapshot* snapshot;
+	int count = ll_item_count(pr->snapshots);
+	int i = 0;
+	
+	for (; i < count; ++i)
+	{
+		snapshot = (PanelSnapshot*)ll_get_next_item(pr->snapshots);
+		if (snapshot->live_layer == live_layer)
+		{
+			return (void*)snapshot;
+		}
+	}
+	
+	return NULL;
+}
+
+void invalidate_panel_snapshot(void* snapshot)
+{
+	PanelSnapshot* ps = (PanelSnapshot*)snapshot;
+	
+	ps->valid = 0;
+	ps->rasterizer->pending = 1;
+	layer_mark_dirty(ps->rasterizer->layer);
+}
+
+Layer* begin_panel_snapshot(void* snapshot)
+{
+	PanelSnapshot* ps = (PanelSnapshot*)snapshot;
+	
+	if (!ps->active)
+	{
+		layer_set_frame(ps->layer, layer_get_frame(ps->live_layer));
+		layer_set_hidden(ps->live_layer, true);
+		layer_set_hidden(ps->layer, false);
+		ps->active = 1;
+	}
+	
+	return ps->layer;
+}
+
+void end_panel_snapshot(void* snapshot)
+{
+	PanelSnapshot* ps = (PanelSnapshot*)snapshot;
+	
+	if (!ps->active)
+	{
+		return;
+	}
+	
+	layer_set_frame(ps->live_layer, layer_get_frame(ps->layer));
+	layer_set_hidden(ps->layer, true);
+	layer_set_hidden(ps->live_layer, false);
+	ps->active = 0;
+}
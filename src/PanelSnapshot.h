@@ -0,0 +1,20 @@
+#ifndef __PANEL_SNAPSHOT_H__
+#define __PANEL_SNAPSHOT_H__
+
+#include <pebble.h>
+
+typedef void (*PanelRenderer)(GContext* ctx, GRect bounds, void* context);
+
+void* init_panel_rasterizer(Layer* parent, GRect region);
+void destroy_panel_rasterizer(void* rasterizer);
+
+void* add_panel_snapshot(void* rasterizer, Layer* live_layer, PanelRenderer render, void* context);
+void* find_panel_snapshot(void* rasterizer, Layer* live_layer);
+void invalidate_panel_snapshot(void* snapshot);
+
+Layer* begin_panel_snapshot(void* snapshot);
+void end_panel_snapshot(void* snapshot);
+
+int capture_screen_region(GContext* ctx, GRect region, GBitmap* destination);
+
+#endif
@@ -1,17 +1,37 @@
 #include <pebble.h>
 
 #include "LayerCollection.h"
+#include "GestureClassifier.h"
+#include "Scheduler.h"
+#include "LogStore.h"
+#include "TemperatureHistory.h"
+#include "SolarTime.h"
+#include "PanelSnapshot.h"
 
 #define PERSISTENT_SETTINGS_KEY 0xDEADBEEF
+#define PERSISTENT_LOCATION_KEY 0xDEADBEF0
+#define TEMPERATURE_LOG_KEY 0x7E000000
+#define TEMPERATURE_LOG_CHUNKS 3
 
 #define ANIM_DURATION 400
 #define ANIM_DELAY 500
 
 #define TIME_LAYER_RETUNR_TIME 2 * 1000
+#define SECONDS_MODE_TIMEOUT 30 * 1000
+#define SECONDS_DIGIT_WIDTH 12
+#define SECONDS_DIGIT_HEIGHT 20
+#define WEATHER_REFRESH_PERIOD 30 * 60 * 1000
+#define HOUR_MS 60 * 60 * 1000
+#define HOURLY_CHIME_MIN_LEAD 60 * 1000
+
+#define GESTURE_SAMPLES_PER_BATCH 5
 
 enum AppMessageCodes {
   KEY_TEMPERATURE = 0,
-  KEY_CONDITIONS = 1
+  KEY_CONDITIONS = 1,
+  KEY_LATITUDE = 2,
+  KEY_LONGITUDE = 3,
+  KEY_UTC_OFFSET = 4
 };
 
 static Window *s_main_window;
@@ -22,34 +42,182 @@ static GBitmap *s_background_bitmap;
 static TextLayer *s_time_layer;
 static TextLayer *s_date_layer;
 static TextLayer *s_weather_layer;
+static Layer *s_history_layer;
+static TextLayer *s_sun_layer;
+
+typedef struct {
+  TextLayer *text_layer;
+  GColor background;
+  GColor foreground;
+  const char *font_key;
+} TextPanel;
+
+static TextPanel s_time_panel = { .background = GColorBlack, .foreground = GColorWhite, .font_key = FONT_KEY_GOTHIC_28 };
+static TextPanel s_date_panel = { .background = GColorWhite, .foreground = GColorBlack, .font_key = FONT_KEY_GOTHIC_28 };
+static TextPanel s_weather_panel = { .background = GColorBlack, .foreground = GColorWhite, .font_key = FONT_KEY_GOTHIC_28 };
+static TextPanel s_sun_panel = { .background = GColorBlack, .foreground = GColorWhite, .font_key = FONT_KEY_GOTHIC_14 };
+
+static void* s_panel_rasterizer = NULL;
+static void* s_incoming_snapshot = NULL;
+
+static Layer *s_seconds_layer;
+static char s_seconds_buffer[] = "00";
+static bool s_seconds_mode = false;
+static GBitmap *s_seconds_digits[10];
+static bool s_seconds_digits_ready = false;
+static int s_seconds_mode_task = 0;
 
 static Layer* s_currently_showing_layer = NULL;
 
 static void* layer_collection = NULL;
 
-static AppTimer* s_time_return_timer = NULL;
+static void* s_scheduler = NULL;
+
+static void* s_temperature_history = NULL;
+static void* s_temperature_log = NULL;
+static int32_t s_last_logged_slot = -1;
+
+typedef struct {
+  uint32_t time;
+  int16_t deci_celsius;
+} __attribute__((__packed__)) TemperatureRecord;
+static int s_time_return_task = 0;
+
+static void* s_gesture_classifier = NULL;
+static bool s_gestures_subscribed = false;
 
 typedef struct {
   int celsius;
   int bt_vibe;
   int hour_vibe;
+  int seconds;
 } __attribute__((__packed__)) WatchSettings;
 
 enum SettingsKeys {
   SETTINGS_CELSIUS = 10,
   SETTINGS_BTVIBE = 11,
   SETTINGS_HOURVIBE = 12,
+  SETTINGS_SECONDS = 13,
   SETTINGS_NUM
 };
 
+typedef struct {
+  int valid;
+  int32_t latitude;
+  int32_t longitude;
+  int32_t utc_offset;
+} __attribute__((__packed__)) WatchLocation;
+
+WatchLocation location = {
+  .valid = 0
+};
+
 WatchSettings settings = {
   .celsius = 1,
   .bt_vibe = 1,
-  .hour_vibe = 1
+  .hour_vibe = 1,
+  .seconds = 0
 };
 
-static void tap_handler(AccelAxisType axis, int32_t direction);
+static void gesture_service_subscribe();
+static void gesture_service_unsubscribe();
 static void time_layer_timeout_handler(void *data);
+static void tick_handler(struct tm *tick_time, TimeUnits units_changed);
+
+static void update_seconds(struct tm *tick_time) {
+  snprintf(s_seconds_buffer, sizeof(s_seconds_buffer), "%02d", tick_time->tm_sec);
+  
+  //the window still recomposes, but the time text keeps its layout and the
+  //seconds themselves are two blits from the digit strip
+  layer_mark_dirty(s_seconds_layer);
+}
+
+static void build_seconds_digits(Layer *layer, GContext *ctx) {
+  GPoint time_origin = layer_get_frame(text_layer_get_layer(s_time_layer)).origin;
+  GRect frame = layer_get_frame(layer);
+  GRect cell = GRect(0, 0, SECONDS_DIGIT_WIDTH, SECONDS_DIGIT_HEIGHT);
+  GRect screen_cell = GRect(time_origin.x + frame.origin.x, time_origin.y + frame.origin.y, SECONDS_DIGIT_WIDTH, SECONDS_DIGIT_HEIGHT);
+  char digit[] = "0";
+  int i = 0;
+  
+  //only capture while the time panel is at rest, mid-slide the cell is off position
+  if (time_origin.x != 0) {
+    return;
+  }
+  
+  for (; i < 10; ++i) {
+    digit[0] = '0' + i;
+    graphics_fill_rect(ctx, cell, 0, GCornerNone);
+    graphics_draw_text(ctx, digit, fonts_get_system_font(FONT_KEY_GOTHIC_18), cell, GTextOverflowModeFill, GTextAlignmentCenter, NULL);
+    
+    if (!capture_screen_region(ctx, screen_cell, s_seconds_digits[i])) {
+      return;
+    }
+  }
+  
+  s_seconds_digits_ready = true;
+}
+
+static void seconds_layer_update_proc(Layer *layer, GContext *ctx) {
+  GRect bounds = layer_get_bounds(layer);
+  
+  graphics_context_set_fill_color(ctx, GColorBlack);
+  graphics_context_set_text_color(ctx, GColorWhite);
+  
+  if (!s_seconds_digits_ready) {
+    build_seconds_digits(layer, ctx);
+  }
+  
+  graphics_fill_rect(ctx, bounds, 0, GCornerNone);
+  
+  if (s_seconds_digits_ready) {
+    graphics_draw_bitmap_in_rect(ctx, s_seconds_digits[s_seconds_buffer[0] - '0'], GRect(0, 0, SECONDS_DIGIT_WIDTH, SECONDS_DIGIT_HEIGHT));
+    graphics_draw_bitmap_in_rect(ctx, s_seconds_digits[s_seconds_buffer[1] - '0'], GRect(SECONDS_DIGIT_WIDTH, 0, SECONDS_DIGIT_WIDTH, SECONDS_DIGIT_HEIGHT));
+  }
+  else {
+    graphics_draw_text(ctx, s_seconds_buffer, fonts_get_system_font(FONT_KEY_GOTHIC_18), bounds, GTextOverflowModeFill, GTextAlignmentLeft, NULL);
+  }
+}
+
+static void seconds_mode_stop() {
+  if (!s_seconds_mode) {
+    return;
+  }
+  
+  s_seconds_mode = false;
+  cancel_task(s_scheduler, s_seconds_mode_task);
+  s_seconds_mode_task = 0;
+  
+  layer_set_hidden(s_seconds_layer, true);
+  tick_timer_service_subscribe(MINUTE_UNIT, tick_handler);
+}
+
+static void seconds_mode_timeout_handler(void *data) {
+  s_seconds_mode_task = 0;
+  seconds_mode_stop();
+}
+
+static void seconds_mode_start() {
+  time_t temp;
+  
+  if (!settings.seconds) {
+    return;
+  }
+  
+  if (s_seconds_mode) {
+    cancel_task(s_scheduler, s_seconds_mode_task);
+    s_seconds_mode_task = schedule_once(s_scheduler, SECONDS_MODE_TIMEOUT, seconds_mode_timeout_handler, NULL);
+    return;
+  }
+  
+  temp = time(NULL);
+  update_seconds(localtime(&temp));
+  
+  s_seconds_mode = true;
+  layer_set_hidden(s_seconds_layer, false);
+  tick_timer_service_subscribe(SECOND_UNIT, tick_handler);
+  s_seconds_mode_task = schedule_once(s_scheduler, SECONDS_MODE_TIMEOUT, seconds_mode_timeout_handler, NULL);
+}
 
 static void animate_layer(Layer *layer, GRect *start, GRect *finish, int duration, int delay, AnimationStartedHandler on_started, AnimationStoppedHandler on_stopped, void* context) {
     PropertyAnimation *anim = property_animation_create_layer_frame(layer, start, finish);
@@ -74,76 +242,134 @@ static GRect get_new_rect_for_layer(GRect to_swap, int direction) {
    return GRect(144 * direction, 87, 144, 38);
 }
 
-static int get_direction_for_swap(GRect layer_to_show) {
-  if (layer_to_show.origin.x >= 144) {
-    return -1;
-  } else if (layer_to_show.origin.x <= -144) {
-    return 1;
-  }
-  return 1;
+static void invalidate_panel(Layer* layer) {
+  invalidate_panel_snapshot(find_panel_snapshot(s_panel_rasterizer, layer));
 }
 
-static void layer_to_show_end_callback(Animation *anim, bool finished, void *layer) {
+static void render_text_panel(GContext* ctx, GRect bounds, void* context) {
+  TextPanel* panel = (TextPanel*)context;
+  
+  graphics_context_set_fill_color(ctx, panel->background);
+  graphics_fill_rect(ctx, bounds, 0, GCornerNone);
+  graphics_context_set_text_color(ctx, panel->foreground);
+  graphics_draw_text(ctx, text_layer_get_text(panel->text_layer), fonts_get_system_font(panel->font_key), bounds, GTextOverflowModeWordWrap, GTextAlignmentCenter, NULL);
+}
+
+static void layer_to_show_end_callback(Animation *anim, bool finished, void *snapshot) {
     property_animation_destroy((PropertyAnimation*) anim);
+    end_panel_snapshot(snapshot);
 
     if (s_currently_showing_layer == text_layer_get_layer(s_time_layer)) {
       //time is now showing, resubscribe
-      accel_tap_service_subscribe(tap_handler);
+      gesture_service_subscribe();
+      seconds_mode_start();
     }
     else {
-      s_time_return_timer = app_timer_register(TIME_LAYER_RETUNR_TIME, (AppTimerCallback)time_layer_timeout_handler, NULL);
+      s_time_return_task = schedule_once(s_scheduler, TIME_LAYER_RETUNR_TIME, time_layer_timeout_handler, NULL);
     }
 }
 
 static void layer_to_hide_start_callback(Animation *animation, void *context) {
-  Layer* hidden = (Layer*)context;
+  Layer* hidden = begin_panel_snapshot(s_incoming_snapshot);
   GRect next_layer_start = layer_get_frame(hidden);
   GRect next_layer_end = get_new_rect_for_layer(next_layer_start, 0);
-  animate_layer(hidden, &next_layer_start, &next_layer_end, ANIM_DURATION, 0, NULL, layer_to_show_end_callback, NULL);
+  animate_layer(hidden, &next_layer_start, &next_layer_end, ANIM_DURATION, 0, NULL, layer_to_show_end_callback, s_incoming_snapshot);
 }
 
-static void layer_to_hide_end_callback(Animation *anim, bool finished, void *layer) {
+static void layer_to_hide_end_callback(Animation *anim, bool finished, void *snapshot) {
   property_animation_destroy((PropertyAnimation*) anim);
+  end_panel_snapshot(snapshot);
 }
 
-static void swap_layers(Layer* showing, Layer* hidden) {
-  GRect current_layer_start = layer_get_frame(showing);
-  GRect next_layer_start = layer_get_frame(hidden);
-  GRect current_layer_end = get_new_rect_for_layer(current_layer_start, get_direction_for_swap(next_layer_start));
+static void swap_layers(Layer* showing, Layer* hidden, int direction) {
+  void* showing_snapshot = find_panel_snapshot(s_panel_rasterizer, showing);
+  Layer* outgoing = begin_panel_snapshot(showing_snapshot);
+  GRect current_layer_start = layer_get_frame(outgoing);
+  GRect current_layer_end = get_new_rect_for_layer(current_layer_start, -direction);
   
+  //bring the incoming layer in from the side the gesture points to
+  layer_set_frame(hidden, GRect(144 * direction, 87, 144, 38));
   s_currently_showing_layer = hidden;
+  s_incoming_snapshot = find_panel_snapshot(s_panel_rasterizer, hidden);
   
-  animate_layer(showing, &current_layer_start, &current_layer_end, ANIM_DURATION, ANIM_DELAY, layer_to_hide_start_callback, layer_to_hide_end_callback, (void*)hidden);
+  //the cached bitmaps slide, the live layers take over again once they land
+  animate_layer(outgoing, &current_layer_start, &current_layer_end, ANIM_DURATION, ANIM_DELAY, layer_to_hide_start_callback, layer_to_hide_end_callback, showing_snapshot);
 }
 
-static void swap_layers_animated() {
-  Layer* next_layer = get_next_layer(layer_collection);
-  app_timer_cancel(s_time_return_timer);
+static void swap_layers_animated(int direction) {
+  Layer* (*advance)(void*) = direction > 0 ? get_next_layer : get_previous_layer;
+  Layer* next_layer = advance(layer_collection);
+  cancel_task(s_scheduler, s_time_return_task);
+  s_time_return_task = 0;
+  seconds_mode_stop();
   
   if (s_currently_showing_layer == next_layer) {
-    next_layer = get_next_layer(layer_collection);
+    next_layer = advance(layer_collection);
   }
   
-  swap_layers(s_currently_showing_layer, next_layer);
+  swap_layers(s_currently_showing_layer, next_layer, direction);
 }
 
 static void time_layer_timeout_handler(void *data) {
    Layer* time_layer = text_layer_get_layer(s_time_layer);
    Layer* current_layer = get_current_layer(layer_collection);
    
+   s_time_return_task = 0;
    APP_LOG(APP_LOG_LEVEL_INFO, "Other Layer Timeout");
    
    if (time_layer == s_currently_showing_layer) {
      return;
    }
    
-   accel_tap_service_unsubscribe();   
+   gesture_service_unsubscribe();
 
-   swap_layers(current_layer, text_layer_get_layer(s_time_layer));
+   set_current_layer(layer_collection, find_layer(layer_collection, time_layer));
+   swap_layers(current_layer, time_layer, -1);
 }
 
-static void tap_handler(AccelAxisType axis, int32_t direction) {
-    swap_layers_animated();
+static void accel_data_handler(AccelData *data, uint32_t num_samples) {
+#ifdef GESTURE_RECORD
+  //same x,y,z,did_vibrate lines test/gesture_replay replays
+  uint32_t i = 0;
+  for (; i < num_samples; ++i) {
+    APP_LOG(APP_LOG_LEVEL_DEBUG, "%d,%d,%d,%d", data[i].x, data[i].y, data[i].z, data[i].did_vibrate ? 1 : 0);
+  }
+#endif
+  
+  switch (classify_gesture_batch(s_gesture_classifier, data, num_samples)) {
+  case GESTURE_FORWARD:
+    swap_layers_animated(1);
+    break;
+  case GESTURE_BACKWARD:
+    swap_layers_animated(-1);
+    break;
+  default:
+    //any other wrist motion while the time is up keeps the seconds going
+    if (gesture_batch_had_motion(s_gesture_classifier) && (s_currently_showing_layer == text_layer_get_layer(s_time_layer))) {
+      seconds_mode_start();
+    }
+    break;
+  }
+}
+
+static void gesture_service_subscribe() {
+  if (s_gestures_subscribed) {
+    return;
+  }
+  
+  reset_gesture_classifier(s_gesture_classifier);
+  accel_data_service_subscribe(GESTURE_SAMPLES_PER_BATCH, accel_data_handler);
+  accel_service_set_sampling_rate(ACCEL_SAMPLING_10HZ);
+  s_gestures_subscribed = true;
+}
+
+static void gesture_service_unsubscribe() {
+  if (!s_gestures_subscribed) {
+    return;
+  }
+  
+  accel_data_service_unsubscribe();
+  s_gestures_subscribed = false;
 }
 
 static void update_date() {
@@ -151,9 +377,17 @@ static void update_date() {
   struct tm *tick_time = localtime(&temp);
 
   static char buffer[] = "00/00/00";
-  strftime(buffer, sizeof(buffer), "%d/%m/%y", tick_time);
+  char text[sizeof(buffer)];
+  strftime(text, sizeof(text), "%d/%m/%y", tick_time);
+  
+  //called every minute, only re-rasterize when the day actually changed
+  if (strcmp(text, buffer) == 0) {
+    return;
+  }
+  strcpy(buffer, text);
   
   text_layer_set_text(s_date_layer, buffer);
+  invalidate_panel(text_layer_get_layer(s_date_layer));
 }
 
 static void update_time() {
@@ -161,18 +395,21 @@ static void update_time() {
   struct tm *tick_time = localtime(&temp);
 
   static char buffer[] = "00:00";
+  char text[sizeof(buffer)];
 
   if(clock_is_24h_style() == true) {
-    strftime(buffer, sizeof("00:00"), "%H:%M", tick_time);
+    strftime(text, sizeof(text), "%H:%M", tick_time);
   } else {
-    strftime(buffer, sizeof("00:00"), "%I:%M", tick_time);
+    strftime(text, sizeof(text), "%I:%M", tick_time);
   }
   
-  if (settings.hour_vibe && (0 == tick_time->tm_min) && (0 == tick_time->tm_sec)) {
-    vibes_short_pulse();
+  if (strcmp(text, buffer) == 0) {
+    return;
   }
+  strcpy(buffer, text);
 
   text_layer_set_text(s_time_layer, buffer);
+  invalidate_panel(text_layer_get_layer(s_time_layer));
 }
 
 static void update_weather_layer(int weather, char* condition)
@@ -194,91 +431,278 @@ static void update_weather_layer(int weather, char* condition)
   
   snprintf(weather_layer_buffer, sizeof(weather_layer_buffer), "%s, %s", temperature_buffer, conditions_buffer);
   text_layer_set_text(s_weather_layer, weather_layer_buffer);
+  invalidate_panel(text_layer_get_layer(s_weather_layer));
+}
+
+static void record_temperature(int temperature) {
+  TemperatureRecord record = {
+    .time = time(NULL),
+    .deci_celsius = settings.celsius ? temperature * 10 : ((temperature - 32) * 50) / 9
+  };
+  
+  int32_t slot = record.time / HISTORY_SLOT_SECONDS;
+  
+  //the phone also sends a reading on every launch, keep one record per slot
+  if (s_temperature_log) {
+    if ((slot != s_last_logged_slot) || !ls_replace_last(s_temperature_log, &record)) {
+      ls_append(s_temperature_log, &record);
+    }
+    s_last_logged_slot = slot;
+  }
+  
+  if (add_temperature_reading(s_temperature_history, record.time, record.deci_celsius)) {
+    layer_mark_dirty(s_history_layer);
+    invalidate_panel(s_history_layer);
+  }
+}
+
+static void load_temperature_history() {
+  void* iterator;
+  const TemperatureRecord* record;
+  
+  if (!s_temperature_log || !(iterator = ls_iterator_create(s_temperature_log))) {
+    return;
+  }
+  
+  while ((record = ls_iterator_next(iterator)) != NULL) {
+    add_temperature_reading(s_temperature_history, record->time, record->deci_celsius);
+    s_last_logged_slot = record->time / HISTORY_SLOT_SECONDS;
+  }
+  
+  ls_iterator_destroy(iterator);
+}
+
+//keeps the graph ending at the current half hour even when no readings arrive
+static void advance_history() {
+  if (advance_temperature_history(s_temperature_history, time(NULL))) {
+    layer_mark_dirty(s_history_layer);
+    invalidate_panel(s_history_layer);
+  }
+}
+
+static void render_history_panel(GContext* ctx, GRect bounds, void* context) {
+  graphics_context_set_fill_color(ctx, GColorWhite);
+  graphics_fill_rect(ctx, bounds, 0, GCornerNone);
+  graphics_context_set_stroke_color(ctx, GColorBlack);
+  graphics_context_set_text_color(ctx, GColorBlack);
+  draw_temperature_history(s_temperature_history, ctx, !settings.celsius);
+}
+
+static void history_layer_update_proc(Layer *layer, GContext *ctx) {
+  render_history_panel(ctx, layer_get_bounds(layer), NULL);
+}
+
+static void format_day_minutes(char* buffer, size_t size, int minutes) {
+  int hours = minutes / 60;
+  
+  if (!clock_is_24h_style()) {
+    hours = hours % 12 == 0 ? 12 : hours % 12;
+  }
+  
+  snprintf(buffer, size, "%02d:%02d", hours, minutes % 60);
+}
+
+static void update_sun_layer() {
+  static char sun_layer_buffer[48];
+  char sunrise[8];
+  char sunset[8];
+  time_t temp = time(NULL);
+  struct tm *tick_time = localtime(&temp);
+  SolarDay day;
+  
+  invalidate_panel(text_layer_get_layer(s_sun_layer));
+  
+  if (!location.valid) {
+    text_layer_set_text(s_sun_layer, "Waiting for location");
+    return;
+  }
+  
+  switch (compute_solar_day(tick_time->tm_yday + 1, location.latitude, location.longitude, location.utc_offset, &day)) {
+  case SOLAR_DAY_POLAR_NIGHT:
+    text_layer_set_text(s_sun_layer, "No sunrise today");
+    return;
+  case SOLAR_DAY_MIDNIGHT_SUN:
+    text_layer_set_text(s_sun_layer, "No sunset today");
+    return;
+  default:
+    break;
+  }
+  
+  format_day_minutes(sunrise, sizeof(sunrise), day.sunrise);
+  format_day_minutes(sunset, sizeof(sunset), day.sunset);
+  snprintf(sun_layer_buffer, sizeof(sun_layer_buffer), "Rise %s  Set %s\nDaylight %dh%02dm", sunrise, sunset, day.day_length / 60, day.day_length % 60);
+  text_layer_set_text(s_sun_layer, sun_layer_buffer);
 }
 
 static void tick_handler(struct tm *tick_time, TimeUnits units_changed) {
+  if (s_seconds_mode) {
+    update_seconds(tick_time);
+  }
+  
+  if (!(units_changed & MINUTE_UNIT)) {
+    return;
+  }
+  
   update_time();
   update_date();
+  advance_history();
   
-  if(tick_time->tm_min % 30 == 0) {
-    DictionaryIterator *iter;
-    app_message_outbox_begin(&iter);
+  if (units_changed & DAY_UNIT) {
+    update_sun_layer();
+  }
+}
+
+static void weather_refresh_handler(void *data) {
+  DictionaryIterator *iter;
+  app_message_outbox_begin(&iter);
+
+  dict_write_uint8(iter, 0, 0);
   
-    dict_write_uint8(iter, 0, 0);
-    
-    app_message_outbox_send();
+  app_message_outbox_send();
+}
+
+static uint32_t ms_until_next_hour(bool rearm) {
+  time_t seconds;
+  uint16_t ms;
+  struct tm *now;
+  uint32_t remaining;
+  
+  time_ms(&seconds, &ms);
+  now = localtime(&seconds);
+  remaining = ((60 - now->tm_min) * 60 - now->tm_sec) * 1000 - ms;
+  
+  //a coalesced chime can run just before the hour, don't chime it twice
+  if (rearm && (remaining < HOURLY_CHIME_MIN_LEAD)) {
+    remaining += HOUR_MS;
   }
+  
+  return remaining;
 }
 
-static TextLayer* create_text_layer_by_dx() {
-  TextLayer* created_layer;
+static void hourly_chime_handler(void *data) {
+  if (settings.hour_vibe) {
+    vibes_short_pulse();
+  }
+  
+  schedule_once(s_scheduler, ms_until_next_hour(true), hourly_chime_handler, NULL);
+}
+
+static GRect get_panel_frame_by_dx() {
+  GRect frame;
   static int dx_counter = 0;
   
   switch(dx_counter) {
     case 1:
-      created_layer = text_layer_create(GRect(144, 87, 144, 38));
+      frame = GRect(144, 87, 144, 38);
       dx_counter = -1;
       break;
     case -1:
-      created_layer = text_layer_create(GRect(-144, 87, 144, 38));
+      frame = GRect(-144, 87, 144, 38);
       dx_counter = -1;
       break;
     default:
-      created_layer = text_layer_create(GRect(0, 87, 144, 38));
+      frame = GRect(0, 87, 144, 38);
       dx_counter = 1;
       break;
   }
   
+  return frame;
+}
+
+static TextLayer* create_text_layer_by_dx() {
+  return text_layer_create(get_panel_frame_by_dx());
+}
+
+static TextLayer* create_text_panel(Window *window, TextPanel *panel, const char *text) {
+  TextLayer* created_layer = create_text_layer_by_dx();
+  
+  text_layer_set_background_color(created_layer, panel->background);
+  text_layer_set_text_color(created_layer, panel->foreground);
+  text_layer_set_text(created_layer, text);
+  text_layer_set_font(created_layer, fonts_get_system_font(panel->font_key));
+  text_layer_set_text_alignment(created_layer, GTextAlignmentCenter);
+  layer_add_child(window_get_root_layer(window), text_layer_get_layer(created_layer));
+  
+  panel->text_layer = created_layer;
   return created_layer;
 }
 
 static void main_window_load(Window *window) {
+  int i;
+  
   s_background_bitmap = gbitmap_create_with_resource(RESOURCE_ID_IMAGE_BACKGROUND);
   s_background_layer = bitmap_layer_create(GRect(0, 0, 144, 168));
   bitmap_layer_set_bitmap(s_background_layer, s_background_bitmap);
   layer_add_child(window_get_root_layer(window), bitmap_layer_get_layer(s_background_layer));
   
-  s_time_layer = create_text_layer_by_dx();
-  text_layer_set_background_color(s_time_layer, GColorBlack);
-  text_layer_set_text_color(s_time_layer, GColorWhite);
-  text_layer_set_text(s_time_layer, "00:00");
-  text_layer_set_font(s_time_layer, fonts_get_system_font(FONT_KEY_GOTHIC_28));
-  text_layer_set_text_alignment(s_time_layer, GTextAlignmentCenter);
-  layer_add_child(window_get_root_layer(window), text_layer_get_layer(s_time_layer));
-  
-  s_date_layer = create_text_layer_by_dx();
-  text_layer_set_background_color(s_date_layer, GColorWhite);
-  text_layer_set_text_color(s_date_layer, GColorBlack);
-  text_layer_set_text(s_date_layer, "00/00/00");
-  text_layer_set_font(s_date_layer, fonts_get_system_font(FONT_KEY_GOTHIC_28));
-  text_layer_set_text_alignment(s_date_layer, GTextAlignmentCenter);
-  layer_add_child(window_get_root_layer(window), text_layer_get_layer(s_date_layer));
-  
-  s_weather_layer = create_text_layer_by_dx();
-  text_layer_set_background_color(s_weather_layer, GColorBlack);
-  text_layer_set_text_color(s_weather_layer, GColorWhite);
-  text_layer_set_text(s_weather_layer, "Noided");
-  text_layer_set_font(s_weather_layer, fonts_get_system_font(FONT_KEY_GOTHIC_28));
-  text_layer_set_text_alignment(s_weather_layer, GTextAlignmentCenter);
-  layer_add_child(window_get_root_layer(window), text_layer_get_layer(s_weather_layer));
+  s_time_layer = create_text_panel(window, &s_time_panel, "00:00");
+  
+  for (i = 0; i < 10; ++i) {
+    s_seconds_digits[i] = gbitmap_create_blank(GSize(SECONDS_DIGIT_WIDTH, SECONDS_DIGIT_HEIGHT));
+  }
+  
+  //x is kept on a byte boundary so the digit strip can be captured from the frame buffer
+  s_seconds_layer = layer_create(GRect(112, 14, 2 * SECONDS_DIGIT_WIDTH, SECONDS_DIGIT_HEIGHT));
+  layer_set_update_proc(s_seconds_layer, seconds_layer_update_proc);
+  layer_set_hidden(s_seconds_layer, true);
+  layer_add_child(text_layer_get_layer(s_time_layer), s_seconds_layer);
+  
+  s_date_layer = create_text_panel(window, &s_date_panel, "00/00/00");
+  s_weather_layer = create_text_panel(window, &s_weather_panel, "Noided");
+  
+  s_temperature_history = init_temperature_history(GRect(40, 4, 96, 30));
+  s_temperature_log = ls_open(TEMPERATURE_LOG_KEY, sizeof(TemperatureRecord), TEMPERATURE_LOG_CHUNKS);
+  load_temperature_history();
+  advance_temperature_history(s_temperature_history, time(NULL));
+  
+  s_history_layer = layer_create(get_panel_frame_by_dx());
+  layer_set_update_proc(s_history_layer, history_layer_update_proc);
+  layer_add_child(window_get_root_layer(window), s_history_layer);
+  
+  s_sun_layer = create_text_panel(window, &s_sun_panel, "");
+  
+  s_panel_rasterizer = init_panel_rasterizer(window_get_root_layer(window), GRect(0, 87, 144, 38));
+  add_panel_snapshot(s_panel_rasterizer, text_layer_get_layer(s_time_layer), render_text_panel, &s_time_panel);
+  add_panel_snapshot(s_panel_rasterizer, text_layer_get_layer(s_date_layer), render_text_panel, &s_date_panel);
+  add_panel_snapshot(s_panel_rasterizer, text_layer_get_layer(s_weather_layer), render_text_panel, &s_weather_panel);
+  add_panel_snapshot(s_panel_rasterizer, s_history_layer, render_history_panel, NULL);
+  add_panel_snapshot(s_panel_rasterizer, text_layer_get_layer(s_sun_layer), render_text_panel, &s_sun_panel);
   
   layer_collection = init_layer_collection();
   add_layer(layer_collection, text_layer_get_layer(s_time_layer));
   add_layer(layer_collection, text_layer_get_layer(s_date_layer));
   add_layer(layer_collection, text_layer_get_layer(s_weather_layer));
+  add_layer(layer_collection, s_history_layer);
+  add_layer(layer_collection, text_layer_get_layer(s_sun_layer));
   
   s_currently_showing_layer = get_current_layer(layer_collection);
   
   update_time();
   update_date();
+  update_sun_layer();
+  seconds_mode_start();
 }
 
 static void main_window_unload(Window *window) {
+  int i;
+  
+  destroy_panel_rasterizer(s_panel_rasterizer);
   gbitmap_destroy(s_background_bitmap);
   bitmap_layer_destroy(s_background_layer);
+  layer_destroy(s_seconds_layer);
+  for (i = 0; i < 10; ++i) {
+    gbitmap_destroy(s_seconds_digits[i]);
+  }
+  s_seconds_digits_ready = false;
   text_layer_destroy(s_time_layer);
   text_layer_destroy(s_date_layer);
   text_layer_destroy(s_weather_layer);
+  layer_destroy(s_history_layer);
+  text_layer_destroy(s_sun_layer);
+  if (s_temperature_log) {
+    ls_close(s_temperature_log);
+  }
+  destroy_temperature_history(s_temperature_history);
   destroy_layer_collection(layer_collection);
 }
 
@@ -289,14 +713,31 @@ static void inbox_received_callback(DictionaryIterator *iterator, void *context)
   
   int temperature = -1;
   char* condition = NULL;
+  int location_changed = 0;
+  int has_weather = 0;
   
   while(t != NULL) {
     switch(t->key) {
     case KEY_TEMPERATURE:
       temperature = (int)t->value->int32;
+      record_temperature(temperature);
+      has_weather = 1;
       break;
     case KEY_CONDITIONS:
       condition = t->value->cstring;
+      has_weather = 1;
+      break;
+    case KEY_LATITUDE:
+      location.latitude = t->value->int32;
+      location_changed = 1;
+      break;
+    case KEY_LONGITUDE:
+      location.longitude = t->value->int32;
+      location_changed = 1;
+      break;
+    case KEY_UTC_OFFSET:
+      location.utc_offset = t->value->int32;
+      location_changed = 1;
       break;
     case SETTINGS_BTVIBE:
       settings.bt_vibe = (int)t->value->int32;
@@ -306,6 +747,13 @@ static void inbox_received_callback(DictionaryIterator *iterator, void *context)
       break;
     case SETTINGS_CELSIUS:
       settings.celsius = (int)t->value->int32;
+      invalidate_panel(s_history_layer);
+      break;
+    case SETTINGS_SECONDS:
+      settings.seconds = (int)t->value->int32;
+      if (!settings.seconds) {
+        seconds_mode_stop();
+      }
       break;
     default:
       APP_LOG(APP_LOG_LEVEL_ERROR, "Key %d not recognized!", (int)t->key);
@@ -314,7 +762,15 @@ static void inbox_received_callback(DictionaryIterator *iterator, void *context)
     t = dict_read_next(iterator);
   }
   
-  update_weather_layer(temperature, condition);
+  if (location_changed) {
+    location.valid = 1;
+    persist_write_data(PERSISTENT_LOCATION_KEY, &location, sizeof(location));
+    update_sun_layer();
+  }
+  
+  if (has_weather) {
+    update_weather_layer(temperature, condition);
+  }
 }
 
 static void inbox_dropped_callback(AppMessageResult reason, void *context) {
@@ -331,6 +787,7 @@ static void outbox_sent_callback(DictionaryIterator *iterator, void *context) {
 
 static void load_settings() {
   persist_read_data(PERSISTENT_SETTINGS_KEY, &settings, sizeof(settings));
+  persist_read_data(PERSISTENT_LOCATION_KEY, &location, sizeof(location));
 }
 
 static void save_settings() {
@@ -342,8 +799,13 @@ static void init() {
   
   s_main_window = window_create();
   
+  s_scheduler = init_scheduler();
+  schedule_periodic(s_scheduler, WEATHER_REFRESH_PERIOD, weather_refresh_handler, NULL);
+  schedule_once(s_scheduler, ms_until_next_hour(false), hourly_chime_handler, NULL);
+  
   tick_timer_service_subscribe(MINUTE_UNIT, tick_handler);
-  accel_tap_service_subscribe(tap_handler);
+  s_gesture_classifier = init_gesture_classifier();
+  gesture_service_subscribe();
 
   app_message_register_inbox_received(inbox_received_callback);
   app_message_open(app_message_inbox_size_maximum(), app_message_outbox_size_maximum());
@@ -362,7 +824,9 @@ static void init() {
 static void deinit() {
   save_settings();
   window_destroy(s_main_window);
-  accel_tap_service_unsubscribe();
+  gesture_service_unsubscribe();
+  destroy_gesture_classifier(s_gesture_classifier);
+  destroy_scheduler(s_scheduler);
 }
 
 int main(void) {
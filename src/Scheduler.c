@@ -0,0 +1,268 @@
+#include "Scheduler.h"
+
+#include <stdlib.h>
+
+#define SCHEDULER_MAX_TASKS 8
+
+//deadlines this close to the one that woke us up run in the same wake-up
+#define SCHEDULER_COALESCE_MS 500
+
+typedef struct
+{
+	int id;
+	uint64_t deadline;
+	uint32_t period;
+	unsigned int generation;
+	SchedulerCallback callback;
+	void* context;
+} ScheduledTask;
+
+typedef struct
+{
+	ScheduledTask tasks[SCHEDULER_MAX_TASKS];
+	int count;
+	int last_id;
+	unsigned int generation;
+	int dispatching;
+	AppTimer* timer;
+	uint64_t last_now;
+} Scheduler;
+
+//Deadlines are on the wall clock, the only millisecond clock the SDK has.
+//When it steps backwards (DST, a time sync from the phone) every deadline is
+//moved back by the observed step, so pending tasks keep their remaining delay
+//give or take the time since the clock was last read. A forward step can't be
+//told apart from time passing and runs the tasks it skips over early.
+static uint64_t scheduler_now(Scheduler* s)
+{
+	time_t seconds;
+	uint16_t ms;
+	uint64_t now;
+	uint64_t step;
+	int i = 0;
+	
+	time_ms(&seconds, &ms);
+	now = ((uint64_t)seconds * 1000) + ms;
+	
+	if (now < s->last_now)
+	{
+		step = s->last_now - now;
+		for (; i < s->count; ++i)
+		{
+			s->tasks[i].deadline = (s->tasks[i].deadline > step) ? (s->tasks[i].deadline - step) : 0;
+		}
+	}
+	
+	s->last_now = now;
+	return now;
+}
+
+static int insert_task(Scheduler* s, ScheduledTask* task)
+{
+	int i = s->count;
+	
+	if (s->count == SCHEDULER_MAX_TASKS)
+	{
+		return 0;
+	}
+	
+	//keep the queue sorted by deadline, ties keep insertion order
+	while ((i > 0) && (s->tasks[i - 1].deadline > task->deadline))
+	{
+		s->tasks[i] = s->tasks[i - 1];
+		--i;
+	}
+	
+	s->tasks[i] = *task;
+	++s->count;
+	return 1;
+}
+
+static void remove_task_at(Scheduler* s, int index)
+{
+	for (; index < (s->count - 1); ++index)
+	{
+		s->tasks[index] = s->tasks[index + 1];
+	}
+	--s->count;
+}
+
+static void scheduler_timer_handler(void* data);
+
+static void arm_timer(Scheduler* s)
+{
+	uint64_t now;
+	uint32_t delay = 1;
+	
+	if (s->dispatching)
+	{
+		return;
+	}
+	
+	if (s->count == 0)
+	{
+		if (s->timer)
+		{
+			app_timer_cancel(s->timer);
+			s->timer = NULL;
+		}
+		return;
+	}
+	
+	now = scheduler_now(s);
+	if (s->tasks[0].deadline > now)
+	{
+		delay = (uint32_t)(s->tasks[0].deadline - now);
+	}
+	
+	if (s->timer && app_timer_reschedule(s->timer, delay))
+	{
+		return;
+	}
+	
+	s->timer = app_timer_register(delay, scheduler_timer_handler, s);
+}
+
+static void scheduler_timer_handler(void* data)
+{
+	Scheduler* s = (Scheduler*)data;
+	uint64_t now = scheduler_now(s);
+	uint64_t horizon = now + SCHEDULER_COALESCE_MS;
+	ScheduledTask task;
+	int i = 0;
+	
+	s->timer = NULL;
+	s->dispatching = 1;
+	++s->generation;
+	
+	while ((i < s->count) && (s->tasks[i].deadline <= horizon))
+	{
+		//anything that already ran or was added in this wake-up waits for the next one
+		if (s->tasks[i].generation == s->generation)
+		{
+			++i;
+			continue;
+		}
+		
+		task = s->tasks[i];
+		remove_task_at(s, i);
+		
+		if (task.period)
+		{
+			task.deadline += task.period;
+			if (task.deadline <= now)
+			{
+				task.deadline = now + task.period;
+			}
+			task.generation = s->generation;
+			insert_task(s, &task);
+		}
+		
+		//the queue may have been changed by the callback, rescan from the front
+		task.callback(task.context);
+		i = 0;
+	}
+	
+	s->dispatching = 0;
+	arm_timer(s);
+}
+
+static int add_task(Scheduler* s, uint32_t delay_ms, uint32_t period_ms, SchedulerCallback callback, void* context)
+{
+	ScheduledTask task;
+	
+	if (NULL == callback)
+	{
+		return 0;
+	}
+	
+	if (++s->last_id <= 0)
+	{
+		s->last_id = 1;
+	}
+	
+	task.id = s->last_id;
+	task.deadline = scheduler_now(s) + delay_ms;
+	task.period = period_ms;
+	task.generation = s->dispatching ? s->generation : 0;
+	task.callback = callback;
+	task.context = context;
+	
+	if (!insert_task(s, &task))
+	{
+		APP_LOG(APP_LOG_LEVEL_ERROR, "Scheduler full!");
+		return 0;
+	}
+	
+	arm_timer(s);
+	return task.id;
+}
+
+void* init_scheduler()
+{
+	Scheduler* s = malloc(sizeof(Scheduler));
+	
+	if (NULL == s)
+	{
+		return NULL;
+	}
+	
+	s->count = 0;
+	s->last_id = 0;
+	s->generation = 0;
+	s->dispatching = 0;
+	s->timer = NULL;
+	s->last_now = 0;
+	
+	return (void*)s;
+}
+
+void destroy_scheduler(void* scheduler)
+{
+	Scheduler* s = (Scheduler*)scheduler;
+	
+	if (s->timer)
+	{
+		app_timer_cancel(s->timer);
+	}
+	
+	free(s);
+}
+
+int schedule_once(void* scheduler, uint32_t delay_ms, SchedulerCallback callback, void* context)
+{
+	return add_task((Scheduler*)scheduler, delay_ms, 0, callback, context);
+}
+
+int schedule_periodic(void* scheduler, uint32_t period_ms, SchedulerCallback callback, void* context)
+{
+	if (period_ms <= SCHEDULER_COALESCE_MS)
+	{
+		return 0;
+	}
+	
+	return add_task((Scheduler*)scheduler, period_ms, period_ms, callback, context);
+}
+
+int cancel_task(void* scheduler, int task_id)
+{
+	Scheduler* s = (Scheduler*)scheduler;
+	int i = 0;
+	
+	if (task_id <= 0)
+	{
+		return 0;
+	}
+	
+	for (; i < s->count; ++i)
+	{
+		if (s->tasks[i].id == task_id)
+		{
+			remove_task_at(s, i);
+			arm_timer(s);
+			return 1;
+		}
+	}
+	
+	return 0;
+}
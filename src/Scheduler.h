@@ -0,0 +1,15 @@
+#ifndef __SCHEDULER_H__
+#define __SCHEDULER_H__
+
+#include <pebble.h>
+
+typedef void (*SchedulerCallback)(void* context);
+
+void* init_scheduler();
+void destroy_scheduler(void* scheduler);
+
+int schedule_once(void* scheduler, uint32_t delay_ms, SchedulerCallback callback, void* context);
+int schedule_periodic(void* scheduler, uint32_t period_ms, SchedulerCallback callback, void* context);
+int cancel_task(void* scheduler, int task_id);
+
+#endif
@@ -0,0 +1,116 @@
+#include "SolarTime.h"
+
+//NOAA general solar position equations evaluated once for local noon, in
+//integer math only. Angles are in TRIG_MAX_ANGLE units and ratios are
+//TRIG_MAX_RATIO scaled, matching sin_lookup/cos_lookup/atan2_lookup.
+
+#define DAY_SECONDS (24 * 60 * 60)
+
+//cos(90.833 degrees), the zenith of a sunrise corrected for refraction and the solar disc
+#define COS_SUNRISE_ZENITH -953
+
+#define UNIT_Q14 (1 << 14)
+
+static int32_t angle_of(int32_t angle)
+{
+	return angle & (TRIG_MAX_ANGLE - 1);
+}
+
+static uint32_t isqrt(uint32_t value)
+{
+	uint32_t result = 0;
+	uint32_t bit = 1UL << 30;
+	
+	while (bit > value)
+	{
+		bit >>= 2;
+	}
+	
+	while (bit != 0)
+	{
+		if (value >= result + bit)
+		{
+			value -= result + bit;
+			result = (result >> 1) + bit;
+		}
+		else
+		{
+			result >>= 1;
+		}
+		bit >>= 2;
+	}
+	
+	return result;
+}
+
+static int wrap_day_minutes(int32_t seconds)
+{
+	seconds %= DAY_SECONDS;
+	if (seconds < 0)
+	{
+		seconds += DAY_SECONDS;
+	}
+	return (seconds + 30) / 60;
+}
+
+SolarDayKind compute_solar_day(int day_of_year, int32_t latitude, int32_t longitude, int32_t utc_offset, SolarDay* result)
+{
+	//fractional year at noon, day_of_year is 1 based
+	int32_t gamma = angle_of(((2 * (day_of_year - 1) + 1) * TRIG_MAX_ANGLE) / 730);
+	int32_t cos1 = cos_lookup(gamma);
+	int32_t sin1 = sin_lookup(gamma);
+	int32_t cos2 = cos_lookup(angle_of(2 * gamma));
+	int32_t sin2 = sin_lookup(angle_of(2 * gamma));
+	int32_t cos3 = cos_lookup(angle_of(3 * gamma));
+	int32_t sin3 = sin_lookup(angle_of(3 * gamma));
+	int32_t declination;
+	int32_t equation_of_time;
+	int32_t lat_angle = angle_of((latitude * TRIG_MAX_ANGLE) / 36000);
+	int64_t numerator;
+	int64_t denominator;
+	int32_t x;
+	int32_t y;
+	int32_t hour_angle;
+	int32_t solar_noon;
+	
+	declination = 72 + ((-4171 * cos1 + 733 * sin1 - 70 * cos2 + 9 * sin2 - 28 * cos3 + 15 * sin3) / TRIG_MAX_RATIO);
+	
+	//in seconds
+	equation_of_time = 1 + ((257 * cos1 - 4411 * sin1 - 2010 * cos2 - 5617 * sin2) / (10 * TRIG_MAX_RATIO));
+	
+	solar_noon = (DAY_SECONDS / 2) - ((longitude * 12) / 5) - equation_of_time + (utc_offset * 60);
+	
+	//cos(hour angle) = (cos(zenith) - sin(lat)sin(decl)) / (cos(lat)cos(decl))
+	numerator = (int64_t)COS_SUNRISE_ZENITH * TRIG_MAX_RATIO - (int64_t)sin_lookup(lat_angle) * sin_lookup(angle_of(declination));
+	denominator = (int64_t)cos_lookup(lat_angle) * cos_lookup(angle_of(declination));
+	
+	result->sunrise = -1;
+	result->sunset = -1;
+	
+	if ((denominator <= 0) || (numerator >= denominator))
+	{
+		result->kind = SOLAR_DAY_POLAR_NIGHT;
+		result->day_length = 0;
+		return result->kind;
+	}
+	
+	if (numerator <= -denominator)
+	{
+		result->kind = SOLAR_DAY_MIDNIGHT_SUN;
+		result->day_length = 24 * 60;
+		return result->kind;
+	}
+	
+	x = (int32_t)((numerator * UNIT_Q14) / denominator);
+	y = (int32_t)isqrt((uint32_t)(UNIT_Q14 * UNIT_Q14 - x * x));
+	hour_angle = atan2_lookup(y, x);
+	
+	//one full turn of hour angle is one day
+	hour_angle = (int32_t)(((int64_t)hour_angle * DAY_SECONDS) / TRIG_MAX_ANGLE);
+	
+	result->kind = SOLAR_DAY_NORMAL;
+	result->sunrise = wrap_day_minutes(solar_noon - hour_angle);
+	result->sunset = wrap_day_minutes(solar_noon + hour_angle);
+	result->day_length = ((2 * hour_angle) + 30) / 60;
+	return result->kind;
+}
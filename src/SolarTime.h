@@ -0,0 +1,25 @@
+#ifndef __SOLAR_TIME_H__
+#define __SOLAR_TIME_H__
+
+#include <pebble.h>
+
+typedef enum
+{
+	SOLAR_DAY_NORMAL = 0,
+	SOLAR_DAY_POLAR_NIGHT,
+	SOLAR_DAY_MIDNIGHT_SUN
+} SolarDayKind;
+
+typedef struct
+{
+	SolarDayKind kind;
+	int sunrise;
+	int sunset;
+	int day_length;
+} SolarDay;
+
+//latitude/longitude in hundredths of a degree (east positive), offset in minutes,
+//results in minutes after local midnight
+SolarDayKind compute_solar_day(int day_of_year, int32_t latitude, int32_t longitude, int32_t utc_offset, SolarDay* result);
+
+#endif
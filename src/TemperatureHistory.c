@@ -0,0 +1,249 @@
+#include "TemperatureHistory.h"
+
+#include <stdlib.h>
+
+//One reading per half hour slot, deci-degrees Celsius, kept as a ring whose
+//head is the newest slot. The plotted y of every slot is cached alongside it,
+//so a new reading only plots its own column unless it changes the range, and
+//moving to a new slot is just advancing the head, which the clock also does
+//so the graph always ends at the current slot. Readings don't land on slot
+//boundaries, so the line bridges up to HISTORY_MAX_GAP_SLOTS empty slots.
+
+#define NO_READING INT16_MIN
+
+typedef struct
+{
+	GRect graph_frame;
+	int head;
+	int32_t newest_slot;
+	int16_t values[HISTORY_SLOTS];
+	uint8_t points[HISTORY_SLOTS];
+	int16_t min;
+	int16_t max;
+	int labels_fahrenheit;
+	char max_label[8];
+	char min_label[8];
+} TemperatureHistory;
+
+static void clear_history(TemperatureHistory* th)
+{
+	int i = 0;
+	
+	for (; i < HISTORY_SLOTS; ++i)
+	{
+		th->values[i] = NO_READING;
+	}
+	
+	th->head = 0;
+	th->newest_slot = -1;
+	th->min = NO_READING;
+	th->max = NO_READING;
+	th->labels_fahrenheit = -1;
+}
+
+static uint8_t plot_value(TemperatureHistory* th, int16_t value)
+{
+	int height = th->graph_frame.size.h - 1;
+	
+	if (th->max == th->min)
+	{
+		return height / 2;
+	}
+	
+	return height - (((int32_t)(value - th->min) * height) / (th->max - th->min));
+}
+
+static int update_range(TemperatureHistory* th)
+{
+	int16_t min = NO_READING;
+	int16_t max = NO_READING;
+	int i = 0;
+	
+	for (; i < HISTORY_SLOTS; ++i)
+	{
+		if (th->values[i] == NO_READING)
+		{
+			continue;
+		}
+		if ((min == NO_READING) || (th->values[i] < min))
+		{
+			min = th->values[i];
+		}
+		if ((max == NO_READING) || (th->values[i] > max))
+		{
+			max = th->values[i];
+		}
+	}
+	
+	if ((min == th->min) && (max == th->max))
+	{
+		return 0;
+	}
+	
+	th->min = min;
+	th->max = max;
+	th->labels_fahrenheit = -1;
+	return 1;
+}
+
+static void format_label(char* buffer, size_t size, int16_t deci_celsius, int fahrenheit)
+{
+	int32_t value = fahrenheit ? ((deci_celsius * 9) / 5) + 320 : deci_celsius;
+	
+	snprintf(buffer, size, "%d°", (int)((value + (value < 0 ? -5 : 5)) / 10));
+}
+
+void* init_temperature_history(GRect graph_frame)
+{
+	TemperatureHistory* th = malloc(sizeof(TemperatureHistory));
+	
+	if (NULL == th)
+	{
+		return NULL;
+	}
+	
+	th->graph_frame = graph_frame;
+	clear_history(th);
+	
+	return (void*)th;
+}
+
+void destroy_temperature_history(void* history)
+{
+	free(history);
+}
+
+static void plot_all(TemperatureHistory* th)
+{
+	int i = 0;
+	
+	for (; i < HISTORY_SLOTS; ++i)
+	{
+		if (th->values[i] != NO_READING)
+		{
+			th->points[i] = plot_value(th, th->values[i]);
+		}
+	}
+}
+
+//shifts in empty slots until the head is slot, returns whether it moved
+static int advance_to_slot(TemperatureHistory* th, int32_t slot)
+{
+	if ((th->newest_slot < 0) || ((slot - th->newest_slot) >= HISTORY_SLOTS))
+	{
+		clear_history(th);
+		th->newest_slot = slot;
+		return 1;
+	}
+	
+	if (slot <= th->newest_slot)
+	{
+		return 0;
+	}
+	
+	for (; th->newest_slot < slot; ++th->newest_slot)
+	{
+		th->head = (th->head + 1) % HISTORY_SLOTS;
+		th->values[th->head] = NO_READING;
+	}
+	return 1;
+}
+
+int advance_temperature_history(void* history, time_t now)
+{
+	TemperatureHistory* th = (TemperatureHistory*)history;
+	
+	if (!advance_to_slot(th, now / HISTORY_SLOT_SECONDS))
+	{
+		return 0;
+	}
+	
+	//readings that scrolled out may have held the min or max
+	if (update_range(th))
+	{
+		plot_all(th);
+	}
+	return 1;
+}
+
+int add_temperature_reading(void* history, time_t when, int16_t deci_celsius)
+{
+	TemperatureHistory* th = (TemperatureHistory*)history;
+	int32_t slot = when / HISTORY_SLOT_SECONDS;
+	int32_t age;
+	int index;
+	
+	advance_to_slot(th, slot);
+	
+	age = th->newest_slot - slot;
+	if (age >= HISTORY_SLOTS)
+	{
+		return 0;
+	}
+	
+	index = (th->head - age + HISTORY_SLOTS) % HISTORY_SLOTS;
+	th->values[index] = deci_celsius;
+	
+	if (update_range(th))
+	{
+		plot_all(th);
+	}
+	else
+	{
+		th->points[index] = plot_value(th, deci_celsius);
+	}
+	
+	return 1;
+}
+
+void draw_temperature_history(void* history, GContext* ctx, int fahrenheit)
+{
+	TemperatureHistory* th = (TemperatureHistory*)history;
+	GRect frame = th->graph_frame;
+	int column_width = frame.size.w / HISTORY_SLOTS;
+	int previous_column = -1;
+	GPoint previous = GPoint(0, 0);
+	GPoint point;
+	int index;
+	int i = 0;
+	
+	if (th->min == NO_READING)
+	{
+		return;
+	}
+	
+	if (th->labels_fahrenheit != fahrenheit)
+	{
+		format_label(th->max_label, sizeof(th->max_label), th->max, fahrenheit);
+		format_label(th->min_label, sizeof(th->min_label), th->min, fahrenheit);
+		th->labels_fahrenheit = fahrenheit;
+	}
+	
+	graphics_draw_text(ctx, th->max_label, fonts_get_system_font(FONT_KEY_GOTHIC_14), GRect(0, frame.origin.y - 4, frame.origin.x, 16), GTextOverflowModeFill, GTextAlignmentLeft, NULL);
+	graphics_draw_text(ctx, th->min_label, fonts_get_system_font(FONT_KEY_GOTHIC_14), GRect(0, frame.origin.y + frame.size.h - 13, frame.origin.x, 16), GTextOverflowModeFill, GTextAlignmentLeft, NULL);
+	
+	//oldest slot first, the one after the head
+	for (; i < HISTORY_SLOTS; ++i)
+	{
+		index = (th->head + 1 + i) % HISTORY_SLOTS;
+		
+		if (th->values[index] == NO_READING)
+		{
+			continue;
+		}
+		
+		point = GPoint(frame.origin.x + (i * column_width), frame.origin.y + th->points[index]);
+		
+		if ((previous_column >= 0) && ((i - previous_column) <= (HISTORY_MAX_GAP_SLOTS + 1)))
+		{
+			graphics_draw_line(ctx, previous, point);
+		}
+		else
+		{
+			graphics_draw_pixel(ctx, point);
+		}
+		
+		previous = point;
+		previous_column = i;
+	}
+}
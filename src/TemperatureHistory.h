@@ -0,0 +1,17 @@
+#ifndef __TEMPERATURE_HISTORY_H__
+#define __TEMPERATURE_HISTORY_H__
+
+#include <pebble.h>
+
+#define HISTORY_SLOTS 48
+#define HISTORY_SLOT_SECONDS (30 * 60)
+#define HISTORY_MAX_GAP_SLOTS 4
+
+void* init_temperature_history(GRect graph_frame);
+void destroy_temperature_history(void* history);
+
+int advance_temperature_history(void* history, time_t now);
+int add_temperature_reading(void* history, time_t when, int16_t deci_celsius);
+void draw_temperature_history(void* history, GContext* ctx, int fahrenheit);
+
+#endif
@@ -1,5 +1,10 @@
 var config = {};
 
+// Minified copy of server/index.html, filled in by the build (see wscript)
+// and opened as a data URI so the configuration page needs no network
+// round trip.
+var configPage = '@CONFIG_PAGE@';
+
 var defaultIfNan = function(value, def)
 {
   return isNaN(value) ? def : value;
@@ -14,6 +19,8 @@ var loadConfig = function()
   config.bt_vibe = defaultIfNan(config.bt_vibe, 1);
   config.hour_vibe = parseInt(localStorage.getItem("hour_vibe"));
   config.hour_vibe = defaultIfNan(config.hour_vibe, 1);
+  config.seconds = parseInt(localStorage.getItem("seconds"));
+  config.seconds = defaultIfNan(config.seconds, 0);
   console.log("config loaded");
 };
 
@@ -23,6 +30,7 @@ var saveConfig = function()
   localStorage.setItem("celsius", config.celsius);  
   localStorage.setItem("bt_vibe", config.bt_vibe); 
   localStorage.setItem("hour_vibe", config.hour_vibe); 
+  localStorage.setItem("seconds", config.seconds); 
 };
 
 var kelvinToCelsius = function(kelvin) {
@@ -33,6 +41,34 @@ var kelvinToFarenheit = function(kelvin) {
   return Math.round((kelvin - 273.15) * 1.8000 + 32.00);
 };
 
+// The watch computes sunrise/sunset itself, so it only needs the location
+// again when it moved noticeably, the timezone changed or once a day.
+var LOCATION_RESEND_DELTA = 10;
+var LOCATION_RESEND_INTERVAL = 24 * 60 * 60 * 1000;
+
+var locationUpdate = function(pos) {
+  var latitude = Math.round(pos.coords.latitude * 100);
+  var longitude = Math.round(pos.coords.longitude * 100);
+  var utcOffset = -new Date().getTimezoneOffset();
+  var last = JSON.parse(localStorage.getItem("last_location") || "null");
+  
+  if (last &&
+      Math.abs(last.latitude - latitude) < LOCATION_RESEND_DELTA &&
+      Math.abs(last.longitude - longitude) < LOCATION_RESEND_DELTA &&
+      last.utcOffset === utcOffset &&
+      Date.now() - last.sent < LOCATION_RESEND_INTERVAL)
+  {
+    return null;
+  }
+  
+  return {
+    latitude: latitude,
+    longitude: longitude,
+    utcOffset: utcOffset,
+    sent: Date.now()
+  };
+};
+
 var xhrRequest = function (url, type, callback) {
   var xhr = new XMLHttpRequest();
   xhr.onload = function () {
@@ -43,7 +79,32 @@ var xhrRequest = function (url, type, callback) {
     xhr.send();
 };
     
+var sendLocation = function(pos) {
+  var location = locationUpdate(pos);
+  
+  if (!location)
+  {
+    return;
+  }
+  
+  // Sent on its own so sunrise/sunset don't depend on the weather request
+  Pebble.sendAppMessage({
+      'KEY_LATITUDE': location.latitude,
+      'KEY_LONGITUDE': location.longitude,
+      'KEY_UTC_OFFSET': location.utcOffset
+    },
+    function(e) {
+      console.log('Location sent to Pebble successfully!');
+      localStorage.setItem("last_location", JSON.stringify(location));
+    },
+    function(e) {
+      console.log('Error sending location to Pebble!');
+    });
+};
+
 var locationSuccess = function(pos) {
+  sendLocation(pos);
+  
   var url = 'http://api.openweathermap.org/data/2.5/weather?lat=' + pos.coords.latitude + '&lon=' + pos.coords.longitude;
   
   // Send request to OpenWeatherMap
@@ -104,11 +165,18 @@ Pebble.addEventListener('appmessage',
 );
 
 Pebble.addEventListener('showConfiguration', function(e){
-  Pebble.openURL('https://still-fjord-3522.herokuapp.com/?conf=' + encodeURIComponent(JSON.stringify(config)));
+  var page = configPage.replace('<script>', '<script>var conf=' + JSON.stringify(config) + ';');
+  Pebble.openURL('data:text/html,' + encodeURIComponent(page + '<!--.html'));
+  //Pebble.openURL('https://still-fjord-3522.herokuapp.com/?conf=' + encodeURIComponent(JSON.stringify(config)));
   //Pebble.openURL('http://10.0.0.11:5000/?conf=' + encodeURIComponent(JSON.stringify(config)));
 });
 
 Pebble.addEventListener('webviewclosed', function(e){
+  if (!e.response)
+  {
+    return;
+  }
+  
   var tempConfig = JSON.parse(decodeURIComponent(e.response));
   console.log(JSON.stringify(config));
   
@@ -125,6 +193,7 @@ Pebble.addEventListener('webviewclosed', function(e){
       "KEY_CELSIUS":parseInt(config.celsius), 
       "KEY_BTVIBE":parseInt(config.bt_vibe), 
       "KEY_HOURVIBE":parseInt(config.hour_vibe), 
+      "KEY_SECONDS":parseInt(config.seconds), 
     }); 
   } 
 });
\ No newline at end of file
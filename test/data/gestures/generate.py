@@ -0,0 +1,111 @@
+#!/usr/bin/env python3
+"""Writes the synthetic gesture traces replayed by test/gesture_replay.c.
+
+These are modelled, not recorded: 10Hz samples in mG of a watch worn face up
+(gravity on -Z), with sensor noise, flicks modelled as a roll of the wrist that
+swings gravity onto +X/-X and back past zero, and the usual non-gesture motion
+(arm swing while walking, raising the arm to look, desk taps, vibes). Real
+traces captured with a GESTURE_RECORD build use the same format and can be
+dropped next to these.
+"""
+
+import math
+import os
+import random
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+FLICK_X = [300, 850, 450, -450, -250, -80, 0]
+
+
+def still(rng, samples, tilt_y=0):
+    out = []
+    for _ in range(samples):
+        out.append((rng.gauss(0, 20), tilt_y + rng.gauss(0, 20), -math.sqrt(max(0, 1000 ** 2 - tilt_y ** 2)) + rng.gauss(0, 20), 0))
+    return out
+
+
+def flick(rng, sign, scale=1.0):
+    out = []
+    for x in FLICK_X:
+        x = sign * x * scale
+        out.append((x + rng.gauss(0, 30), rng.gauss(0, 40), -math.sqrt(max(0, 1000 ** 2 - x ** 2)) + rng.gauss(0, 30), 0))
+    return out
+
+
+def walking(rng, samples):
+    out = []
+    for i in range(samples):
+        phase = 2 * math.pi * i / 10.0
+        out.append((120 * math.sin(phase + 0.5) + rng.gauss(0, 40),
+                    450 * math.sin(phase) + rng.gauss(0, 40),
+                    -850 + 250 * math.cos(2 * phase) + rng.gauss(0, 40), 0))
+    return out
+
+
+def arm_raise(rng):
+    out = []
+    for i in range(10):
+        y = -900 + 90 * i
+        out.append((rng.gauss(0, 60), y + rng.gauss(0, 40), -math.sqrt(max(0, 1000 ** 2 - y ** 2)) + rng.gauss(0, 40), 0))
+    return out
+
+
+def desk_tap(rng):
+    x = rng.choice([-1, 1]) * 700
+    return [(x, 300, -600, 0)]
+
+
+def vibe(rng, samples):
+    return [(rng.choice([-1, 1]) * rng.randint(400, 1200), rng.gauss(0, 300), -1000 + rng.gauss(0, 300), 1) for _ in range(samples)]
+
+
+def write(name, expect, samples):
+    with open(os.path.join(HERE, name), 'w') as f:
+        f.write('# synthetic trace, see generate.py\n')
+        f.write('# expect:%s\n' % ''.join(' ' + e for e in expect))
+        for x, y, z, v in samples:
+            f.write('%d,%d,%d,%d\n' % (round(x), round(y), round(z), v))
+
+
+def main():
+    rng = random.Random(2015)
+
+    write('still.csv', [], still(rng, 300))
+
+    s = still(rng, 20)
+    for _ in range(3):
+        s += flick(rng, 1) + still(rng, 15)
+    write('forward.csv', ['forward'] * 3, s)
+
+    s = still(rng, 20)
+    for _ in range(3):
+        s += flick(rng, -1) + still(rng, 15)
+    write('backward.csv', ['backward'] * 3, s)
+
+    s = still(rng, 17)
+    for sign, scale in ((1, 1.0), (-1, 0.8), (1, 1.2), (-1, 1.0)):
+        s += flick(rng, sign, scale) + still(rng, 18)
+    write('mixed.csv', ['forward', 'backward', 'forward', 'backward'], s)
+
+    write('walking.csv', [], still(rng, 10) + walking(rng, 300))
+
+    s = still(rng, 10)
+    for _ in range(4):
+        s += arm_raise(rng) + still(rng, 20, tilt_y=0)
+    write('arm_raise.csv', [], s)
+
+    s = still(rng, 10)
+    for _ in range(6):
+        s += desk_tap(rng) + still(rng, 12)
+    write('desk_taps.csv', [], s)
+
+    write('vibe.csv', [], still(rng, 10) + vibe(rng, 20) + still(rng, 30))
+
+    # the confirmation vibe lands inside the lockout, the bounce after it must
+    # not count as a second flick
+    s = still(rng, 20) + flick(rng, 1) + vibe(rng, 2) + flick(rng, 1, 0.9) + still(rng, 20)
+    write('flick_vibe.csv', ['forward'], s)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,206 @@
+#include <pebble.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "GestureClassifier.h"
+
+//Replays accelerometer traces through the classifier in the same batches the
+//watch delivers and checks the gestures against the trace's "# expect:" line,
+//then times the classifier per batch. Synthetic traces (generate.py) were
+//modelled against the classifier's own thresholds, so on those this is a
+//regression check, not a measure of detection accuracy; traces recorded with
+//a GESTURE_RECORD build are what show the latter.
+
+#define SAMPLES_PER_BATCH 5
+#define MAX_SAMPLES 4096
+#define MAX_EXPECTED 32
+#define TIMING_ROUNDS 20000
+
+typedef struct
+{
+	AccelData samples[MAX_SAMPLES];
+	int count;
+	Gesture expected[MAX_EXPECTED];
+	int expected_count;
+	int synthetic;
+} Trace;
+
+static Gesture parse_gesture(const char* name)
+{
+	if (0 == strcmp(name, "forward"))
+	{
+		return GESTURE_FORWARD;
+	}
+	if (0 == strcmp(name, "backward"))
+	{
+		return GESTURE_BACKWARD;
+	}
+	return GESTURE_NONE;
+}
+
+static const char* gesture_name(Gesture gesture)
+{
+	switch (gesture)
+	{
+	case GESTURE_FORWARD:
+		return "forward";
+	case GESTURE_BACKWARD:
+		return "backward";
+	default:
+		return "none";
+	}
+}
+
+static int load_trace(const char* path, Trace* trace)
+{
+	FILE* file = fopen(path, "r");
+	char line[256];
+	char* token;
+	int x;
+	int y;
+	int z;
+	int vibrate;
+	
+	if (NULL == file)
+	{
+		return 0;
+	}
+	
+	trace->count = 0;
+	trace->expected_count = 0;
+	trace->synthetic = 0;
+	
+	while (fgets(line, sizeof(line), file))
+	{
+		if (0 == strncmp(line, "# expect:", 9))
+		{
+			for (token = strtok(line + 9, " \r\n"); token && (trace->expected_count < MAX_EXPECTED); token = strtok(NULL, " \r\n"))
+			{
+				trace->expected[trace->expected_count++] = parse_gesture(token);
+			}
+			continue;
+		}
+		
+		if (0 == strncmp(line, "# synthetic", 11))
+		{
+			trace->synthetic = 1;
+		}
+		
+		if ((line[0] == '#') || (trace->count == MAX_SAMPLES))
+		{
+			continue;
+		}
+		
+		if (4 == sscanf(line, "%d,%d,%d,%d", &x, &y, &z, &vibrate))
+		{
+			AccelData* sample = &trace->samples[trace->count++];
+			sample->x = x;
+			sample->y = y;
+			sample->z = z;
+			sample->did_vibrate = vibrate != 0;
+			sample->timestamp = trace->count * 100;
+		}
+	}
+	
+	fclose(file);
+	return 1;
+}
+
+static int replay(void* classifier, Trace* trace, Gesture* found, int max_found)
+{
+	int found_count = 0;
+	int i = 0;
+	Gesture gesture;
+	
+	reset_gesture_classifier(classifier);
+	
+	for (; i + SAMPLES_PER_BATCH <= trace->count; i += SAMPLES_PER_BATCH)
+	{
+		gesture = classify_gesture_batch(classifier, &trace->samples[i], SAMPLES_PER_BATCH);
+		if ((gesture != GESTURE_NONE) && (found_count < max_found))
+		{
+			found[found_count++] = gesture;
+		}
+	}
+	
+	return found_count;
+}
+
+static double now_ns()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec * 1e9) + ts.tv_nsec;
+}
+
+int main(int argc, char** argv)
+{
+	static Trace trace;
+	void* classifier = init_gesture_classifier();
+	Gesture found[MAX_EXPECTED];
+	int found_count;
+	int failures = 0;
+	int synthetic = 0;
+	long total_batches = 0;
+	double total_ns = 0;
+	double start;
+	int round;
+	int i;
+	int j;
+	
+	if (argc < 2)
+	{
+		fprintf(stderr, "usage: %s trace.csv...\n", argv[0]);
+		return 2;
+	}
+	
+	for (i = 1; i < argc; ++i)
+	{
+		int ok;
+		
+		if (!load_trace(argv[i], &trace))
+		{
+			printf("FAIL %s: cannot read\n", argv[i]);
+			++failures;
+			continue;
+		}
+		
+		found_count = replay(classifier, &trace, found, MAX_EXPECTED);
+		ok = (found_count == trace.expected_count);
+		for (j = 0; ok && (j < found_count); ++j)
+		{
+			ok = (found[j] == trace.expected[j]);
+		}
+		
+		printf("%s %s%s: expected %d gesture(s), got", ok ? "ok  " : "FAIL", argv[i], trace.synthetic ? " (synthetic)" : "", trace.expected_count);
+		for (j = 0; j < found_count; ++j)
+		{
+			printf(" %s", gesture_name(found[j]));
+		}
+		printf("\n");
+		failures += !ok;
+		synthetic += trace.synthetic;
+		
+		start = now_ns();
+		for (round = 0; round < TIMING_ROUNDS; ++round)
+		{
+			replay(classifier, &trace, found, MAX_EXPECTED);
+		}
+		total_ns += now_ns() - start;
+		total_batches += (long)TIMING_ROUNDS * (trace.count / SAMPLES_PER_BATCH);
+	}
+	
+	if (synthetic > 0)
+	{
+		printf("%d of %d traces are synthetic: regression only, not detection accuracy\n", synthetic, argc - 1);
+	}
+	
+	if (total_batches > 0)
+	{
+		printf("classifier cost: %.1f ns per %d-sample batch (%ld batches, host CPU)\n", total_ns / total_batches, SAMPLES_PER_BATCH, total_batches);
+	}
+	
+	destroy_gesture_classifier(classifier);
+	return failures ? 1 : 0;
+}
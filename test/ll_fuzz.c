@@ -0,0 +1,366 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "LinkedList.h"
+
+//Drives LinkedList with random operations and checks every result against a
+//plain array model. The list is grown to the requested size, then churned at
+//that size. LinkedList.c is built with malloc/free renamed to the counting
+//wrappers below, so peak heap use and leaks after destroy are reported too.
+//
+//  ll_fuzz [max_items [churn_ops [seed]]]
+
+typedef union
+{
+	size_t size;
+	long double align;
+} AllocationHeader;
+
+static long s_live_allocations = 0;
+static long s_peak_allocations = 0;
+static size_t s_live_bytes = 0;
+static size_t s_peak_bytes = 0;
+
+void* fuzz_malloc(size_t size)
+{
+	AllocationHeader* header = malloc(sizeof(AllocationHeader) + size);
+	
+	if (NULL == header)
+	{
+		return NULL;
+	}
+	
+	header->size = size;
+	s_live_bytes += size;
+	++s_live_allocations;
+	if (s_live_bytes > s_peak_bytes)
+	{
+		s_peak_bytes = s_live_bytes;
+	}
+	if (s_live_allocations > s_peak_allocations)
+	{
+		s_peak_allocations = s_live_allocations;
+	}
+	return header + 1;
+}
+
+void fuzz_free(void* pointer)
+{
+	AllocationHeader* header;
+	
+	if (NULL == pointer)
+	{
+		return;
+	}
+	
+	header = (AllocationHeader*)pointer - 1;
+	s_live_bytes -= header->size;
+	--s_live_allocations;
+	free(header);
+}
+
+typedef struct
+{
+	void* list;
+	void** items;
+	int count;
+	int current;
+	int max_items;
+	intptr_t next_item;
+	long step;
+} Fuzzer;
+
+static void fail(Fuzzer* fuzzer, const char* what)
+{
+	printf("FAIL %s at step %ld (count %d, current %d)\n", what, fuzzer->step, fuzzer->count, fuzzer->current);
+	exit(1);
+}
+
+static int random_index(int count)
+{
+	return rand() % count;
+}
+
+//mirrors the list: removing the current item moves current to the one before
+//it, wrapping to the tail, and an emptied list has no current item
+static void model_remove(Fuzzer* fuzzer, int index)
+{
+	memmove(&fuzzer->items[index], &fuzzer->items[index + 1], (fuzzer->count - index - 1) * sizeof(void*));
+	--fuzzer->count;
+	
+	if (fuzzer->count == 0)
+	{
+		fuzzer->current = -1;
+	}
+	else if (index < fuzzer->current)
+	{
+		--fuzzer->current;
+	}
+	else if (index == fuzzer->current)
+	{
+		fuzzer->current = (index == 0) ? fuzzer->count - 1 : index - 1;
+	}
+}
+
+static void add_item(Fuzzer* fuzzer)
+{
+	void* item = (void*)++fuzzer->next_item;
+	
+	if (!ll_add_item(fuzzer->list, item))
+	{
+		fail(fuzzer, "ll_add_item");
+	}
+	fuzzer->items[fuzzer->count++] = item;
+}
+
+//ll_add_item_at inserts after the item at index
+static void add_item_at(Fuzzer* fuzzer)
+{
+	void* item = (void*)++fuzzer->next_item;
+	int index = random_index(fuzzer->count);
+	
+	if (!ll_add_item_at(fuzzer->list, item, index))
+	{
+		fail(fuzzer, "ll_add_item_at");
+	}
+	
+	memmove(&fuzzer->items[index + 2], &fuzzer->items[index + 1], (fuzzer->count - index - 1) * sizeof(void*));
+	fuzzer->items[index + 1] = item;
+	++fuzzer->count;
+	if (fuzzer->current > index)
+	{
+		++fuzzer->current;
+	}
+}
+
+static void remove_item(Fuzzer* fuzzer)
+{
+	int index = random_index(fuzzer->count);
+	
+	if (!ll_remove_item(fuzzer->list, fuzzer->items[index]))
+	{
+		fail(fuzzer, "ll_remove_item");
+	}
+	model_remove(fuzzer, index);
+}
+
+static void remove_item_at(Fuzzer* fuzzer)
+{
+	int index = random_index(fuzzer->count);
+	
+	if (!ll_remove_item_at(fuzzer->list, index))
+	{
+		fail(fuzzer, "ll_remove_item_at");
+	}
+	model_remove(fuzzer, index);
+	
+	if (ll_remove_item_at(fuzzer->list, fuzzer->count))
+	{
+		fail(fuzzer, "ll_remove_item_at past the end");
+	}
+}
+
+static void step_next(Fuzzer* fuzzer)
+{
+	void* item = ll_get_next_item(fuzzer->list);
+	
+	fuzzer->current = (fuzzer->current + 1) % fuzzer->count;
+	if (item != fuzzer->items[fuzzer->current])
+	{
+		fail(fuzzer, "ll_get_next_item");
+	}
+}
+
+static void step_previous(Fuzzer* fuzzer)
+{
+	void* item = ll_get_previous_item(fuzzer->list);
+	
+	fuzzer->current = (fuzzer->current <= 0) ? fuzzer->count - 1 : fuzzer->current - 1;
+	if (item != fuzzer->items[fuzzer->current])
+	{
+		fail(fuzzer, "ll_get_previous_item");
+	}
+}
+
+static void set_current(Fuzzer* fuzzer)
+{
+	int index = random_index(fuzzer->count);
+	
+	if (!ll_set_current_item(fuzzer->list, index))
+	{
+		fail(fuzzer, "ll_set_current_item");
+	}
+	fuzzer->current = index;
+	
+	if (ll_get_current_item(fuzzer->list) != fuzzer->items[index])
+	{
+		fail(fuzzer, "ll_get_current_item");
+	}
+	if (ll_get_previous_index(fuzzer->list) != ((index == 0) ? fuzzer->count - 1 : index - 1))
+	{
+		fail(fuzzer, "ll_get_previous_index");
+	}
+	if (ll_get_next_index(fuzzer->list) != ((index + 1) % fuzzer->count))
+	{
+		fail(fuzzer, "ll_get_next_index");
+	}
+	if (ll_is_index_in_range(fuzzer->list, fuzzer->count) || ll_is_index_in_range(fuzzer->list, -1))
+	{
+		fail(fuzzer, "ll_is_index_in_range");
+	}
+}
+
+static void find_item(Fuzzer* fuzzer)
+{
+	int index = random_index(fuzzer->count);
+	
+	if (ll_find_item(fuzzer->list, fuzzer->items[index]) != index)
+	{
+		fail(fuzzer, "ll_find_item");
+	}
+}
+
+//one random operation; adds are weighted by add_weight out of 10 so the grow
+//phase fills the list and the churn phase holds it near max_items
+static void random_operation(Fuzzer* fuzzer, int add_weight)
+{
+	int roll = rand() % 10;
+	int can_add = fuzzer->count < fuzzer->max_items;
+	
+	if ((fuzzer->count == 0) || (can_add && (roll < add_weight)))
+	{
+		if ((fuzzer->count > 0) && (rand() & 1))
+		{
+			add_item_at(fuzzer);
+		}
+		else
+		{
+			add_item(fuzzer);
+		}
+	}
+	else
+	{
+		switch (rand() % 7)
+		{
+		case 0:
+			remove_item(fuzzer);
+			break;
+		case 1:
+			remove_item_at(fuzzer);
+			break;
+		case 2:
+			step_next(fuzzer);
+			break;
+		case 3:
+			step_previous(fuzzer);
+			break;
+		case 4:
+			set_current(fuzzer);
+			break;
+		case 5:
+			find_item(fuzzer);
+			break;
+		default:
+			//asking for the index of an unset current item settles it on the head
+			if (fuzzer->current == -1)
+			{
+				fuzzer->current = 0;
+			}
+			if (ll_current_item_index(fuzzer->list) != fuzzer->current)
+			{
+				fail(fuzzer, "ll_current_item_index");
+			}
+			break;
+		}
+	}
+	
+	if (ll_item_count(fuzzer->list) != fuzzer->count)
+	{
+		fail(fuzzer, "ll_item_count");
+	}
+	++fuzzer->step;
+}
+
+//walks the whole list once from the head and compares it with the model
+static void verify_order(Fuzzer* fuzzer)
+{
+	int i;
+	
+	if (fuzzer->count == 0)
+	{
+		return;
+	}
+	
+	ll_set_current_item(fuzzer->list, fuzzer->count - 1);
+	for (i = 0; i < fuzzer->count; ++i)
+	{
+		if (ll_get_next_item(fuzzer->list) != fuzzer->items[i])
+		{
+			fail(fuzzer, "list order");
+		}
+	}
+	fuzzer->current = fuzzer->count - 1;
+}
+
+static double now_seconds()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + (ts.tv_nsec / 1e9);
+}
+
+static void report(const char* phase, long operations, double seconds, int count)
+{
+	printf("%-6s %9ld ops in %7.2fs, %10.0f ops/s, %d items\n", phase, operations, seconds, operations / seconds, count);
+}
+
+int main(int argc, char** argv)
+{
+	Fuzzer fuzzer;
+	long churn_ops = (argc > 2) ? atol(argv[2]) : 100000;
+	unsigned seed = (argc > 3) ? (unsigned)atoi(argv[3]) : 1;
+	double start;
+	long ops;
+	
+	memset(&fuzzer, 0, sizeof(fuzzer));
+	fuzzer.max_items = (argc > 1) ? atoi(argv[1]) : 20000;
+	fuzzer.current = -1;
+	fuzzer.items = malloc((fuzzer.max_items + 1) * sizeof(void*));
+	if ((fuzzer.max_items < 1) || (NULL == fuzzer.items))
+	{
+		fprintf(stderr, "usage: %s [max_items [churn_ops [seed]]]\n", argv[0]);
+		return 2;
+	}
+	
+	srand(seed);
+	fuzzer.list = ll_init_linked_list();
+	
+	start = now_seconds();
+	while (fuzzer.count < fuzzer.max_items)
+	{
+		random_operation(&fuzzer, 8);
+	}
+	verify_order(&fuzzer);
+	report("grow", fuzzer.step, now_seconds() - start, fuzzer.count);
+	
+	ops = fuzzer.step;
+	start = now_seconds();
+	while (fuzzer.step - ops < churn_ops)
+	{
+		random_operation(&fuzzer, 5);
+	}
+	verify_order(&fuzzer);
+	report("churn", churn_ops, now_seconds() - start, fuzzer.count);
+	
+	printf("peak heap: %zu bytes in %ld allocations (%.1f bytes per item)\n",
+		s_peak_bytes, s_peak_allocations, (double)s_peak_bytes / fuzzer.max_items);
+	
+	ll_destroy_linked_list(fuzzer.list);
+	free(fuzzer.items);
+	
+	printf("leaked: %zu bytes in %ld allocations\n", s_live_bytes, s_live_allocations);
+	return (s_live_allocations != 0) ? 1 : 0;
+}
@@ -0,0 +1,33 @@
+#ifndef __HOST_PEBBLE_H__
+#define __HOST_PEBBLE_H__
+
+//Host stand-in for the parts of the SDK the pure-logic modules use, so they
+//can be built and exercised by the programs in test/ without a watch.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <time.h>
+
+#define TRIG_MAX_RATIO 0xffff
+#define TRIG_MAX_ANGLE 0x10000
+
+#define APP_LOG_LEVEL_ERROR 1
+#define APP_LOG_LEVEL_INFO 3
+#define APP_LOG(level, fmt, ...) fprintf(stderr, fmt "\n", ##__VA_ARGS__)
+
+typedef struct
+{
+	int16_t x;
+	int16_t y;
+	int16_t z;
+	bool did_vibrate;
+	uint64_t timestamp;
+} AccelData;
+
+int32_t sin_lookup(int32_t angle);
+int32_t cos_lookup(int32_t angle);
+int32_t atan2_lookup(int16_t y, int16_t x);
+
+#endif
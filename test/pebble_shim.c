@@ -0,0 +1,34 @@
+#include <pebble.h>
+
+#include <math.h>
+
+#define TWO_PI 6.28318530717958647692
+
+//Same scaling as the SDK lookup tables: angles in TRIG_MAX_ANGLE per turn,
+//ratios scaled by TRIG_MAX_RATIO.
+
+static double to_radians(int32_t angle)
+{
+	return (TWO_PI * angle) / TRIG_MAX_ANGLE;
+}
+
+int32_t sin_lookup(int32_t angle)
+{
+	return (int32_t)lround(sin(to_radians(angle)) * TRIG_MAX_RATIO);
+}
+
+int32_t cos_lookup(int32_t angle)
+{
+	return (int32_t)lround(cos(to_radians(angle)) * TRIG_MAX_RATIO);
+}
+
+int32_t atan2_lookup(int16_t y, int16_t x)
+{
+	double angle = atan2(y, x);
+	
+	if (angle < 0)
+	{
+		angle += TWO_PI;
+	}
+	return (int32_t)lround((angle * TRIG_MAX_ANGLE) / (TWO_PI)) & (TRIG_MAX_ANGLE - 1);
+}
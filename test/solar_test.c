@@ -0,0 +1,108 @@
+#include <pebble.h>
+
+#include <stdlib.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC 1
+#endif
+
+#include "SolarTime.h"
+
+//Checks compute_solar_day against published sunrise/sunset times (minutes
+//after local midnight, civil time of the place) and times one computation.
+//Day length is rounded on its own, so it may be a minute off sunset - sunrise.
+//The trig comes from pebble_shim.c, so the cost is the host's, not the watch's.
+
+#define TOLERANCE_MINUTES 2
+#define TIMING_ROUNDS 200000
+
+typedef struct
+{
+	const char* place;
+	int day_of_year;
+	int32_t latitude;
+	int32_t longitude;
+	int32_t utc_offset;
+	SolarDayKind kind;
+	int sunrise;
+	int sunset;
+} Reference;
+
+#define HM(h, m) (((h) * 60) + (m))
+
+static const Reference references[] =
+{
+	{ "London, June 21",       172,  5151,   -13,   60, SOLAR_DAY_NORMAL,       HM(4, 43), HM(21, 21) },
+	{ "New York, January 1",     1,  4071, -7401, -300, SOLAR_DAY_NORMAL,       HM(7, 20), HM(16, 39) },
+	{ "Sydney, December 21",   355, -3387, 15121,  660, SOLAR_DAY_NORMAL,       HM(5, 41), HM(20, 5) },
+	{ "Quito, March 20",        80,   -22, -7851, -300, SOLAR_DAY_NORMAL,       HM(6, 18), HM(18, 25) },
+	{ "Tromso, June 21",       172,  6965,  1896,  120, SOLAR_DAY_MIDNIGHT_SUN, -1, -1 },
+	{ "Tromso, December 21",   355,  6965,  1896,   60, SOLAR_DAY_POLAR_NIGHT,  -1, -1 },
+};
+
+#define REFERENCE_COUNT ((int)(sizeof(references) / sizeof(references[0])))
+
+static double now_ns()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec * 1e9) + ts.tv_nsec;
+}
+
+static int check(const Reference* reference)
+{
+	SolarDay day;
+	SolarDayKind kind = compute_solar_day(reference->day_of_year, reference->latitude, reference->longitude, reference->utc_offset, &day);
+	int ok = (kind == reference->kind) && (day.kind == kind);
+	
+	if (ok && (kind == SOLAR_DAY_NORMAL))
+	{
+		ok = (abs(day.sunrise - reference->sunrise) <= TOLERANCE_MINUTES) &&
+			(abs(day.sunset - reference->sunset) <= TOLERANCE_MINUTES) &&
+			(abs(day.day_length - (day.sunset - day.sunrise)) <= 1);
+	}
+	
+	printf("%s %-22s kind %d rise %4d (want %4d) set %4d (want %4d)\n", ok ? "ok  " : "FAIL",
+		reference->place, kind, day.sunrise, reference->sunrise, day.sunset, reference->sunset);
+	return ok;
+}
+
+int main(int argc, char** argv)
+{
+	SolarDay day;
+	volatile int sink = 0;
+	int failures = 0;
+	double start;
+	int round;
+	int i;
+#ifdef HAVE_TSC
+	unsigned long long cycles;
+#endif
+	
+	for (i = 0; i < REFERENCE_COUNT; ++i)
+	{
+		failures += !check(&references[i]);
+	}
+	
+	start = now_ns();
+#ifdef HAVE_TSC
+	cycles = __rdtsc();
+#endif
+	for (round = 0; round < TIMING_ROUNDS; ++round)
+	{
+		const Reference* reference = &references[round % REFERENCE_COUNT];
+		sink += compute_solar_day((reference->day_of_year + round) % 365 + 1, reference->latitude, reference->longitude, reference->utc_offset, &day);
+	}
+#ifdef HAVE_TSC
+	cycles = __rdtsc() - cycles;
+#endif
+	
+	printf("solar day cost: %.1f ns", (now_ns() - start) / TIMING_ROUNDS);
+#ifdef HAVE_TSC
+	printf(", %.0f TSC cycles", (double)cycles / TIMING_ROUNDS);
+#endif
+	printf(" per computation (%d rounds, host CPU)\n", TIMING_ROUNDS);
+	
+	return failures ? 1 : 0;
+}